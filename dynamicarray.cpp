@@ -1,59 +1,160 @@
 #include <algorithm>
 #include <functional>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include "memoryresource.cpp"
+#include "sorting.cpp"
 
+// Память выделяется без инициализации: конструируются только живые элементы
+// [0, size), поэтому T не обязан иметь конструктор по умолчанию.
+// Память берётся из memory_resource (по умолчанию - глобальный); копия и
+// перемещение наследуют ресурс источника, присваивание копией - сохраняет свой
 template <typename T>
 class DynamicArray {
 private:
     T  *data      = nullptr;
     int capacity  = 0;
     int size      = 0;
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource();
+
+    T *allocate(int count) const {
+        if (count == 0) return nullptr;
+        return static_cast<T *>(resource->allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    void deallocate(T *memory, int count) {
+        if (memory) resource->deallocate(memory, sizeof(T) * count, alignof(T));
+    }
+
+    void destroyFrom(int from) {
+        std::destroy(data + from, data + size);
+        size = from;
+    }
 
     void reallocate(int new_capacity) {
         if (new_capacity < size) new_capacity = size;
         if (new_capacity == capacity) return;
 
-        T *tmp = new T[new_capacity];
-        for (int i = 0; i < size; ++i) tmp[i] = std::move(data[i]);
-        delete[] data;
+        T *tmp = allocate(new_capacity);
+        std::uninitialized_move(data, data + size, tmp);
+        std::destroy(data, data + size);
+        deallocate(data, capacity);
+        data     = tmp;
+        capacity = new_capacity;
+    }
+
+    // Новый элемент конструируется в новом блоке до переноса старых,
+    // поэтому аргументы могут ссылаться на элементы самого массива
+    template <typename... Args>
+    void growAndEmplace(Args &&...args) {
+        int new_capacity = capacity ? capacity * 2 : 1;
+        T *tmp = allocate(new_capacity);
+        try {
+            new (tmp + size) T(std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(tmp, new_capacity);
+            throw;
+        }
+        std::uninitialized_move(data, data + size, tmp);
+        std::destroy(data, data + size);
+        deallocate(data, capacity);
         data     = tmp;
         capacity = new_capacity;
+        ++size;
+    }
+
+    // Буфер для сортировок: элементы в нём должны быть живыми. Временная
+    // память берётся из глобального ресурса, чтобы не засорять арены
+    DynamicArray scratch() const {
+        if constexpr (std::is_default_constructible<T>::value) return DynamicArray(size);
+        else return DynamicArray(*this, std::pmr::get_default_resource());
     }
 
 public:
-    DynamicArray() : data(new T[1]), capacity(1), size(0) {}
+    DynamicArray() = default;
+
+    explicit DynamicArray(std::pmr::memory_resource *resource) : resource(resource) {}
 
-    explicit DynamicArray(int initial_size)
-        : capacity(initial_size > 0 ? initial_size : 1),
-          size(initial_size)
+    explicit DynamicArray(int initial_size, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : resource(resource)
     {
-        data = new T[capacity];
-        std::fill_n(data, size, T());
+        if (initial_size < 0) throw std::invalid_argument("Size cannot be negative");
+        data     = allocate(initial_size);
+        capacity = initial_size;
+        std::uninitialized_value_construct_n(data, initial_size);
+        size     = initial_size;
     }
 
-    DynamicArray(const DynamicArray &other)
-        : data(new T[other.capacity]), capacity(other.capacity), size(other.size)
+    DynamicArray(const T *items, int count, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : resource(resource)
     {
-        std::copy(other.data, other.data + size, data);
+        if (count < 0) throw std::invalid_argument("Count cannot be negative");
+        data     = allocate(count);
+        capacity = count;
+        std::uninitialized_copy(items, items + count, data);
+        size     = count;
+    }
+
+    DynamicArray(const DynamicArray &other) : DynamicArray(other, other.resource) {}
+
+    DynamicArray(const DynamicArray &other, std::pmr::memory_resource *resource) : resource(resource) {
+        data     = allocate(other.capacity);
+        capacity = other.capacity;
+        std::uninitialized_copy(other.data, other.data + other.size, data);
+        size     = other.size;
     }
 
     DynamicArray &operator=(const DynamicArray &other) {
         if (this == &other) return *this;
-        delete[] data;
+        T *tmp = allocate(other.capacity);
+        std::uninitialized_copy(other.data, other.data + other.size, tmp);
+        destroyFrom(0);
+        deallocate(data, capacity);
+        data     = tmp;
         capacity = other.capacity;
         size     = other.size;
-        data     = new T[capacity];
-        std::copy(other.data, other.data + size, data);
         return *this;
     }
 
-    ~DynamicArray() { delete[] data; }
+    DynamicArray(DynamicArray &&other) noexcept
+        : data(other.data), capacity(other.capacity), size(other.size), resource(other.resource)
+    {
+        other.data     = nullptr;
+        other.capacity = 0;
+        other.size     = 0;
+    }
+
+    DynamicArray &operator=(DynamicArray &&other) noexcept {
+        if (this == &other) return *this;
+        destroyFrom(0);
+        deallocate(data, capacity);
+        data     = other.data;
+        capacity = other.capacity;
+        size     = other.size;
+        resource = other.resource;
+        other.data     = nullptr;
+        other.capacity = 0;
+        other.size     = 0;
+        return *this;
+    }
+
+    ~DynamicArray() {
+        destroyFrom(0);
+        deallocate(data, capacity);
+    }
 
     void Reserve(int new_capacity) { if (new_capacity > capacity) reallocate(new_capacity); }
 
     void Resize(int new_size) {
         if (new_size < 0) throw std::invalid_argument("Size cannot be negative");
+        if (new_size <= size) {
+            destroyFrom(new_size);
+            return;
+        }
         if (new_size > capacity) reallocate(std::max(new_size, capacity * 2));
+        std::uninitialized_value_construct(data + size, data + new_size);
         size = new_size;
     }
 
@@ -62,22 +163,75 @@ public:
         return data[index];
     }
 
-    void Set(int index, T value) {
+    T &operator[](int index) { return data[index]; }
+    const T &operator[](int index) const { return data[index]; }
+
+    void Set(int index, const T &value) {
         if (index < 0 || index >= size) throw std::out_of_range("Index out of range");
         data[index] = value;
     }
 
-    void Append(T item) {  
-        if (size == capacity) reallocate(capacity ? capacity * 2 : 1);
-        data[size++] = item;
+    void Set(int index, T &&value) {
+        if (index < 0 || index >= size) throw std::out_of_range("Index out of range");
+        data[index] = std::move(value);
     }
 
-    void SortInPlace(const std::function<bool(const T&, const T&)> &comp = [](const T &a, const T &b){ return a < b; }) {
-        for (int i = 0; i < size; ++i)
-            for (int j = 0; j < size - i - 1; ++j)
-                if (!comp(data[j], data[j + 1])) std::swap(data[j], data[j + 1]);
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args) {
+        if (size == capacity) growAndEmplace(std::forward<Args>(args)...);
+        else {
+            new (data + size) T(std::forward<Args>(args)...);
+            ++size;
+        }
+        return data[size - 1];
     }
 
+    void Append(const T &item) { EmplaceBack(item); }
+    void Append(T &&item) { EmplaceBack(std::move(item)); }
+
+    // Для арифметических T с порядком по умолчанию используется поразрядная сортировка
+    template <typename Compare = std::less<T>>
+    void SortInPlace(Compare comp = Compare()) {
+        if constexpr (UsesRadixSort<T, Compare>()) {
+            if (size >= RadixSortThreshold) {
+                DynamicArray buffer = scratch();
+                RadixSort(data, data + size, buffer.data);
+            } else {
+                // Тот же порядок, что и у поразрядной сортировки (-0.0 и NaN)
+                IntroSort(data, data + size, RadixKeyLess<T>());
+            }
+            return;
+        }
+        IntroSort(data, data + size, comp);
+    }
+
+    template <typename Compare = std::less<T>>
+    void StableSortInPlace(Compare comp = Compare()) {
+        DynamicArray buffer = scratch();
+        StableSort(data, data + size, buffer.data, comp);
+    }
+
+    // threads = 0 - по числу аппаратных потоков
+    template <typename Compare = std::less<T>>
+    void SortInPlaceParallel(Compare comp = Compare(), int threads = 0) {
+        if (size < ParallelSortThreshold) {
+            SortInPlace(comp);
+            return;
+        }
+        DynamicArray buffer = scratch();
+        // std::less не задаёт строгого порядка на NaN, а слиянию частей он нужен;
+        // сравнение по ключу даёт строгий порядок, совпадающий с SortInPlace
+        if constexpr (UsesRadixSort<T, Compare>()) ParallelSort(data, data + size, buffer.data, RadixKeyLess<T>(), threads);
+        else ParallelSort(data, data + size, buffer.data, comp, threads);
+    }
+
+    // Элементы лежат подряд, итераторами служат указатели
+    T       *begin()       { return data; }
+    T       *end()         { return data + size; }
+    const T *begin() const { return data; }
+    const T *end()   const { return data + size; }
+
     int GetSize() const { return size; }
     int GetCapacity() const { return capacity; }
+    std::pmr::memory_resource *GetResource() const { return resource; }
 };
\ No newline at end of file
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "indexiterator.cpp"
+#include "sequence.cpp"
+
+// Буфер с разрывом: элементы [0, gapStart) и [gapEnd, capacity) живые, между
+// ними свободное место. Курсор стоит в начале разрыва, поэтому вставка и
+// удаление у курсора - O(1), а перенос курсора стоит столько, на сколько он
+// сдвинулся. Вставка в произвольную позицию сначала переносит туда курсор.
+// В слотах разрыва объектов нет: при переносе курсора элементы переезжают
+// через разрыв конструированием перемещением
+template <typename T>
+class GapBufferSequence : public MutableSequence<T> {
+public:
+    // Индексы итераторов логические, разрыв пропускается
+    using Iterator      = IndexIterator<GapBufferSequence, T, false>;
+    using ConstIterator = IndexIterator<GapBufferSequence, T, true>;
+
+    GapBufferSequence() = default;
+
+    explicit GapBufferSequence(std::pmr::memory_resource *resource) : resource(resource) {}
+
+    GapBufferSequence(T *items, int n, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : resource(resource)
+    {
+        if (n < 0) throw std::invalid_argument("Count cannot be negative");
+        reserveGap(n);
+        for (int i = 0; i < n; ++i) EmplaceAtCursor(items[i]);
+    }
+
+    // Копия наследует ресурс источника, элементы в ней лежат без разрыва
+    GapBufferSequence(const GapBufferSequence &other) : GapBufferSequence(other.resource) { copyFrom(other); }
+
+    GapBufferSequence(GapBufferSequence &&other) noexcept
+        : data(other.data), capacity(other.capacity), gapStart(other.gapStart), gapEnd(other.gapEnd), resource(other.resource)
+    {
+        other.data = nullptr;
+        other.capacity = other.gapStart = other.gapEnd = 0;
+    }
+
+    GapBufferSequence &operator=(const GapBufferSequence &other) {
+        if (this == &other) return *this;
+        GapBufferSequence copy(resource);
+        copy.copyFrom(other);
+        *this = std::move(copy);
+        return *this;
+    }
+
+    GapBufferSequence &operator=(GapBufferSequence &&other) noexcept {
+        if (this == &other) return *this;
+        release();
+        data = other.data;
+        capacity = other.capacity;
+        gapStart = other.gapStart;
+        gapEnd = other.gapEnd;
+        resource = other.resource;
+        other.data = nullptr;
+        other.capacity = other.gapStart = other.gapEnd = 0;
+        return *this;
+    }
+
+    ~GapBufferSequence() { release(); }
+
+    T GetFirst() const override {
+        if (!GetLength()) throw std::out_of_range("Sequence is empty");
+        return at(0);
+    }
+    T GetLast() const override {
+        if (!GetLength()) throw std::out_of_range("Sequence is empty");
+        return at(GetLength() - 1);
+    }
+    T Get(int i) const override {
+        if (i < 0 || i >= GetLength()) throw std::out_of_range("Index out of range");
+        return at(i);
+    }
+    int GetLength() const override { return capacity - (gapEnd - gapStart); }
+    std::pmr::memory_resource *GetResource() const { return resource; }
+
+    Sequence<T>* GetSubsequence(int l, int r) const override {
+        if (l < 0 || r >= GetLength() || l > r) throw std::out_of_range("Invalid indices");
+        auto *sub = new GapBufferSequence(resource);
+        try {
+            sub->reserveGap(r - l + 1);
+            for (int i = l; i <= r; ++i) sub->EmplaceAtCursor(at(i));
+        } catch (...) {
+            delete sub;
+            throw;
+        }
+        return sub;
+    }
+    SequenceView<T, GapBufferSequence> GetSlice(int l, int r) const { return SequenceView<T, GapBufferSequence>(*this, l, r); }
+
+    Sequence<T>* Append(T item) const override {
+        auto *copy = new GapBufferSequence(*this);
+        copy->AppendInPlace(std::move(item));
+        return copy;
+    }
+    Sequence<T>* Prepend(T item) const override {
+        auto *copy = new GapBufferSequence(*this);
+        copy->PrependInPlace(std::move(item));
+        return copy;
+    }
+    Sequence<T>* InsertAt(T item, int idx) const override {
+        if (idx < 0 || idx > GetLength()) throw std::out_of_range("Index out of range");
+        auto *copy = new GapBufferSequence(*this);
+        copy->InsertAtInPlace(std::move(item), idx);
+        return copy;
+    }
+    Sequence<T>* Concat(Sequence<T>* other) const override {
+        auto *res = new GapBufferSequence(*this);
+        res->reserveGap(other->GetLength());
+        other->ForEach([res](const T &item) { res->EmplaceAtCursor(item); });
+        return res;
+    }
+
+    void ForEach(const std::function<void(const T &)> &action) const override {
+        for (int i = 0; i < gapStart; ++i) action(data[i]);
+        for (int i = gapEnd; i < capacity; ++i) action(data[i]);
+    }
+
+    void AppendInPlace(const T &item) override { EmplaceAt(GetLength(), item); }
+    void AppendInPlace(T &&item) override { EmplaceAt(GetLength(), std::move(item)); }
+    void PrependInPlace(const T &item) override { EmplaceAt(0, item); }
+    void PrependInPlace(T &&item) override { EmplaceAt(0, std::move(item)); }
+    void InsertAtInPlace(const T &item, int idx) override { EmplaceAt(idx, item); }
+    void InsertAtInPlace(T &&item, int idx) override { EmplaceAt(idx, std::move(item)); }
+
+    // Переносит курсор и вставляет элемент перед ним
+    template <typename... Args>
+    void EmplaceAt(int idx, Args &&...args) {
+        if (idx < 0 || idx > GetLength()) throw std::out_of_range("Index out of range");
+        T item(std::forward<Args>(args)...);
+        MoveCursor(idx);
+        EmplaceAtCursor(std::move(item));
+    }
+
+    // Вставка перед курсором, курсор остаётся после нового элемента
+    template <typename... Args>
+    T &EmplaceAtCursor(Args &&...args) {
+        if (gapStart == gapEnd) {
+            // Элемент собирается до reserveGap: args может указывать в старый блок
+            T item(std::forward<Args>(args)...);
+            reserveGap(1);
+            return *new (data + gapStart++) T(std::move(item));
+        }
+        return *new (data + gapStart++) T(std::forward<Args>(args)...);
+    }
+
+    // Удаляет элемент перед курсором
+    T EraseBeforeCursor() {
+        if (gapStart == 0) throw std::out_of_range("No element before cursor");
+        T &item = data[--gapStart];
+        T result = std::move(item);
+        item.~T();
+        return result;
+    }
+
+    // Удаляет элемент после курсора
+    T EraseAfterCursor() {
+        if (gapEnd == capacity) throw std::out_of_range("No element after cursor");
+        T &item = data[gapEnd++];
+        T result = std::move(item);
+        item.~T();
+        return result;
+    }
+
+    T RemoveAt(int idx) {
+        if (idx < 0 || idx >= GetLength()) throw std::out_of_range("Index out of range");
+        MoveCursor(idx);
+        return EraseAfterCursor();
+    }
+
+    int GetCursor() const { return gapStart; }
+
+    T &operator[](int i) { return at(i); }
+    const T &operator[](int i) const { return at(i); }
+
+    // Переносит курсор в позицию idx; стоимость - |idx - GetCursor()| перемещений
+    void MoveCursor(int idx) {
+        if (idx < 0 || idx > GetLength()) throw std::out_of_range("Index out of range");
+        int gap = gapEnd - gapStart;
+        if (gap == 0) {
+            // Разрыв пуст: курсор переносится без перемещения элементов
+            gapStart = gapEnd = idx;
+            return;
+        }
+        while (gapStart > idx) {
+            --gapStart;
+            relocate(gapStart, gapStart + gap);
+        }
+        while (gapStart < idx) {
+            relocate(gapStart + gap, gapStart);
+            ++gapStart;
+        }
+        gapEnd = gapStart + gap;
+    }
+
+    Iterator      begin()       { return Iterator(this, 0); }
+    Iterator      end()         { return Iterator(this, GetLength()); }
+    ConstIterator begin() const { return ConstIterator(this, 0); }
+    ConstIterator end()   const { return ConstIterator(this, GetLength()); }
+
+private:
+    T  *data     = nullptr;
+    int capacity = 0;
+    int gapStart = 0;
+    int gapEnd   = 0;
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource();
+
+    T &at(int i) { return data[i < gapStart ? i : i + (gapEnd - gapStart)]; }
+    const T &at(int i) const { return data[i < gapStart ? i : i + (gapEnd - gapStart)]; }
+
+    void relocate(int from, int to) {
+        new (data + to) T(std::move(data[from]));
+        data[from].~T();
+    }
+
+    // Расширяет разрыв хотя бы до count свободных мест, удваивая ёмкость
+    void reserveGap(int count) {
+        if (gapEnd - gapStart >= count) return;
+        int length = GetLength();
+        int newCapacity = std::max(capacity * 2, length + count);
+        newCapacity = std::max(newCapacity, 8);
+        T *target = static_cast<T *>(resource->allocate(sizeof(T) * newCapacity, alignof(T)));
+        int tail = capacity - gapEnd;
+        int newGapEnd = newCapacity - tail;
+        for (int i = 0; i < gapStart; ++i) {
+            new (target + i) T(std::move(data[i]));
+            data[i].~T();
+        }
+        for (int i = 0; i < tail; ++i) {
+            new (target + newGapEnd + i) T(std::move(data[gapEnd + i]));
+            data[gapEnd + i].~T();
+        }
+        if (data) resource->deallocate(data, sizeof(T) * capacity, alignof(T));
+        data = target;
+        capacity = newCapacity;
+        gapEnd = newGapEnd;
+    }
+
+    void copyFrom(const GapBufferSequence &other) {
+        reserveGap(other.GetLength());
+        for (const T &item : other) EmplaceAtCursor(item);
+    }
+
+    void release() {
+        std::destroy(data, data + gapStart);
+        std::destroy(data + gapEnd, data + capacity);
+        if (data) resource->deallocate(data, sizeof(T) * capacity, alignof(T));
+        data = nullptr;
+        capacity = gapStart = gapEnd = 0;
+    }
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// Итератор произвольного доступа для контейнеров с доступом по индексу:
+// хранит контейнер и логический индекс, разыменование идёт через operator[]
+// контейнера, поэтому раскладка элементов в памяти итератору не важна
+template <typename Container, typename T, bool IsConst>
+class IndexIterator {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = T;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = std::conditional_t<IsConst, const T *, T *>;
+    using reference         = std::conditional_t<IsConst, const T &, T &>;
+    using Owner             = std::conditional_t<IsConst, const Container, Container>;
+
+    IndexIterator() = default;
+    IndexIterator(Owner *container, int index) : container(container), index(index) {}
+
+    template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+    IndexIterator(const IndexIterator<Container, T, OtherConst> &other) : container(other.container), index(other.index) {}
+
+    reference operator*() const  { return (*container)[index]; }
+    pointer   operator->() const { return &(*container)[index]; }
+    reference operator[](difference_type n) const { return (*container)[index + n]; }
+
+    IndexIterator &operator++() { ++index; return *this; }
+    IndexIterator &operator--() { --index; return *this; }
+    IndexIterator  operator++(int) { IndexIterator old = *this; ++index; return old; }
+    IndexIterator  operator--(int) { IndexIterator old = *this; --index; return old; }
+
+    IndexIterator &operator+=(difference_type n) { index += n; return *this; }
+    IndexIterator &operator-=(difference_type n) { index -= n; return *this; }
+
+    friend IndexIterator operator+(IndexIterator it, difference_type n) { return it += n; }
+    friend IndexIterator operator+(difference_type n, IndexIterator it) { return it += n; }
+    friend IndexIterator operator-(IndexIterator it, difference_type n) { return it -= n; }
+
+    difference_type operator-(const IndexIterator &other) const { return index - other.index; }
+
+    bool operator==(const IndexIterator &other) const { return index == other.index; }
+    bool operator!=(const IndexIterator &other) const { return index != other.index; }
+    bool operator<(const IndexIterator &other) const  { return index < other.index; }
+    bool operator>(const IndexIterator &other) const  { return index > other.index; }
+    bool operator<=(const IndexIterator &other) const { return index <= other.index; }
+    bool operator>=(const IndexIterator &other) const { return index >= other.index; }
+
+private:
+    template <typename, typename, bool> friend class IndexIterator;
+
+    Owner *container = nullptr;
+    int    index     = 0;
+};
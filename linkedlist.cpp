@@ -1,28 +1,119 @@
+#include <cstddef>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "memoryresource.cpp"
+#include "nodepool.cpp"
 
 
+// Двусвязный список: удаление с конца за O(1), Get идёт с ближнего конца.
+// Узлы выдаются пулом (NodePool), блоки пула берутся из memory_resource.
+// Пул создаётся при первой вставке; его можно разделить между списками
 template <typename T>
 class LinkedList {
 public:
     struct Node {
         T     data;
         Node *next;
-        explicit Node(T value) : data(value), next(nullptr) {}
+        Node *prev;
+        template <typename... Args>
+        explicit Node(Args &&...args) : data(std::forward<Args>(args)...), next(nullptr), prev(nullptr) {}
     };
 
+    using Pool = NodePool<Node>;
 
-    LinkedList(T *items, int count) : head(nullptr), tail(nullptr), length(0) {
+    // Двунаправленный итератор по узлам; у end() узла нет, поэтому
+    // декремент end() берёт хвост списка
+    template <bool IsConst>
+    class BasicIterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = std::conditional_t<IsConst, const T *, T *>;
+        using reference         = std::conditional_t<IsConst, const T &, T &>;
+
+        BasicIterator() = default;
+        BasicIterator(Node *node, const LinkedList *list) : node(node), list(list) {}
+
+        // Неконстантный итератор приводится к константному
+        template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+        BasicIterator(const BasicIterator<OtherConst> &other) : node(other.node), list(other.list) {}
+
+        reference operator*() const  { return node->data; }
+        pointer   operator->() const { return &node->data; }
+
+        BasicIterator &operator++() { node = node->next; return *this; }
+        BasicIterator &operator--() { node = node ? node->prev : list->tail; return *this; }
+        BasicIterator  operator++(int) { BasicIterator old = *this; ++*this; return old; }
+        BasicIterator  operator--(int) { BasicIterator old = *this; --*this; return old; }
+
+        bool operator==(const BasicIterator &other) const { return node == other.node; }
+        bool operator!=(const BasicIterator &other) const { return node != other.node; }
+
+    private:
+        template <bool> friend class BasicIterator;
+
+        Node             *node = nullptr;
+        const LinkedList *list = nullptr;
+    };
+
+    using Iterator      = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+
+    LinkedList(T *items, int count, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : LinkedList(resource)
+    {
         if (count < 0) throw std::invalid_argument("Count cannot be negative");
         for (int i = 0; i < count; ++i) Append(items[i]);
     }
 
-    LinkedList() : head(nullptr), tail(nullptr), length(0) {}
+    LinkedList() : LinkedList(std::pmr::get_default_resource()) {}
+
+    explicit LinkedList(std::pmr::memory_resource *resource)
+        : head(nullptr), tail(nullptr), length(0), resource(resource) {}
+
+    explicit LinkedList(std::shared_ptr<Pool> pool)
+        : head(nullptr), tail(nullptr), length(0), pool(pool), resource(pool->GetResource()) {}
 
-    LinkedList(const LinkedList &other) : LinkedList() {
+    LinkedList(const LinkedList &other) : LinkedList(other.resource) {
         for (Node *p = other.head; p; p = p->next) Append(p->data);
     }
 
+    LinkedList(LinkedList &&other) noexcept
+        : head(other.head), tail(other.tail), length(other.length), pool(std::move(other.pool)), resource(other.resource)
+    {
+        other.head = other.tail = nullptr;
+        other.length = 0;
+    }
+
+    LinkedList &operator=(const LinkedList &other) {
+        if (this == &other) return *this;
+        LinkedList copy = pool ? LinkedList(pool) : LinkedList(resource);
+        for (Node *p = other.head; p; p = p->next) copy.Append(p->data);
+        clear();
+        *this = std::move(copy);
+        return *this;
+    }
+
+    LinkedList &operator=(LinkedList &&other) noexcept {
+        if (this == &other) return *this;
+        clear();
+        head = other.head;
+        tail = other.tail;
+        length = other.length;
+        pool = std::move(other.pool);
+        resource = other.resource;
+        other.head = other.tail = nullptr;
+        other.length = 0;
+        return *this;
+    }
+
     ~LinkedList() {
         clear();
     }
@@ -32,27 +123,87 @@ public:
     T             Get(int index) const;
     int           GetLength() const { return length; }
     LinkedList   *GetSubList(int startIndex, int endIndex) const;
-    void          Prepend(T item);
-    void          Append(T item);
-    void          InsertAt(T item, int index);
+    void          Prepend(const T &item) { EmplaceFront(item); }
+    void          Prepend(T &&item)      { EmplaceFront(std::move(item)); }
+    void          Append(const T &item)  { EmplaceBack(item); }
+    void          Append(T &&item)       { EmplaceBack(std::move(item)); }
+    void          InsertAt(const T &item, int index) { EmplaceAt(index, item); }
+    void          InsertAt(T &&item, int index)      { EmplaceAt(index, std::move(item)); }
+    template <typename... Args> T &EmplaceFront(Args &&...args);
+    template <typename... Args> T &EmplaceBack(Args &&...args);
+    template <typename... Args> T &EmplaceAt(int index, Args &&...args);
     void          RemoveAt(int index);
     void          RemoveFirst();
     void          RemoveLast();
-    bool          Remove(T item);
+    bool          Remove(const T &item);
     LinkedList   *Concat(LinkedList *list) const;
+    void          SpliceBack(LinkedList &other);
+    void          AppendMoved(LinkedList &&other) { SpliceBack(other); }
     Node         *GetHeadNode() const { return head; }
     Node         *GetTailNode() const { return tail; }
+    std::pmr::memory_resource *GetResource() const { return resource; }
+
+    Iterator      begin()       { return Iterator(head, this); }
+    Iterator      end()         { return Iterator(nullptr, this); }
+    ConstIterator begin() const { return ConstIterator(head, this); }
+    ConstIterator end()   const { return ConstIterator(nullptr, this); }
+
+    // Пул узлов списка; передав его конструктору другого списка, пул можно разделить
+    std::shared_ptr<Pool> GetPool() {
+        if (!pool) pool = std::make_shared<Pool>(resource);
+        return pool;
+    }
 
 private:
     Node *head;
     Node *tail;
     int   length;
+    std::shared_ptr<Pool>      pool;
+    std::pmr::memory_resource *resource;
+
+    template <typename... Args>
+    Node *createNode(Args &&...args) {
+        if (!pool) pool = std::make_shared<Pool>(resource);
+        void *memory = pool->Allocate();
+        try {
+            return new (memory) Node(std::forward<Args>(args)...);
+        } catch (...) {
+            pool->Deallocate(memory);
+            throw;
+        }
+    }
+
+    void destroyNode(Node *node) {
+        node->~Node();
+        pool->Deallocate(node);
+    }
+
+    Node *nodeAt(int index) const {
+        Node *p;
+        if (index < length / 2) {
+            p = head;
+            while (index--) p = p->next;
+        } else {
+            p = tail;
+            for (int i = length - 1; i > index; --i) p = p->prev;
+        }
+        return p;
+    }
+
+    void eraseNode(Node *node) {
+        if (node->prev) node->prev->next = node->next;
+        else head = node->next;
+        if (node->next) node->next->prev = node->prev;
+        else tail = node->prev;
+        destroyNode(node);
+        --length;
+    }
 
     void clear() {
         while (head) {
             Node *tmp = head;
             head = head->next;
-            delete tmp;
+            destroyNode(tmp);
         }
         tail = nullptr;
         length = 0;
@@ -61,23 +212,29 @@ private:
 
 
 template <typename T>
-void LinkedList<T>::Append(T item) {
-    Node *node = new Node(item);
+template <typename... Args>
+T &LinkedList<T>::EmplaceBack(Args &&...args) {
+    Node *node = createNode(std::forward<Args>(args)...);
     if (!head) head = tail = node;
     else {
+        node->prev = tail;
         tail->next = node;
         tail = node;
     }
     ++length;
+    return node->data;
 }
 
 template <typename T>
-void LinkedList<T>::Prepend(T item) {
-    Node *node = new Node(item);
+template <typename... Args>
+T &LinkedList<T>::EmplaceFront(Args &&...args) {
+    Node *node = createNode(std::forward<Args>(args)...);
     node->next = head;
+    if (head) head->prev = node;
     head = node;
     if (!tail) tail = head;
     ++length;
+    return node->data;
 }
 
 template <typename T>
@@ -95,102 +252,50 @@ T LinkedList<T>::GetLast() const {
 template <typename T>
 T LinkedList<T>::Get(int index) const {
     if (index < 0 || index >= length) throw std::out_of_range("Index out of range");
-    Node *p = head;
-    while (index--) p = p->next;
-    return p->data;
+    return nodeAt(index)->data;
 }
 
 template <typename T>
-void LinkedList<T>::InsertAt(T item, int index) {
+template <typename... Args>
+T &LinkedList<T>::EmplaceAt(int index, Args &&...args) {
     if (index < 0 || index > length) throw std::out_of_range("Index out of range");
-    if (index == 0)      { Prepend(item); return; }
-    if (index == length) { Append(item);  return; }
-
-    Node *prev = head;
-    for (int i = 1; i < index; ++i) prev = prev->next;
-    Node *node = new Node(item);
-    node->next = prev->next;
-    prev->next = node;
+    if (index == 0)      return EmplaceFront(std::forward<Args>(args)...);
+    if (index == length) return EmplaceBack(std::forward<Args>(args)...);
+
+    Node *next = nodeAt(index);
+    Node *node = createNode(std::forward<Args>(args)...);
+    node->prev = next->prev;
+    node->next = next;
+    next->prev->next = node;
+    next->prev = node;
     ++length;
+    return node->data;
 }
 
 template <typename T>
 void LinkedList<T>::RemoveAt(int index) {
     if (index < 0 || index >= length) throw std::out_of_range("Index out of range");
-    
-    if (index == 0) {
-        RemoveFirst();
-        return;
-    }
-    
-    Node *prev = head;
-    for (int i = 1; i < index; ++i) prev = prev->next;
-    
-    Node *toDelete = prev->next;
-    prev->next = toDelete->next;
-    
-    if (toDelete == tail) tail = prev;
-    
-    delete toDelete;
-    --length;
+    eraseNode(nodeAt(index));
 }
 
 template <typename T>
 void LinkedList<T>::RemoveFirst() {
     if (!head) throw std::runtime_error("List is empty");
-    
-    Node *toDelete = head;
-    head = head->next;
-    
-    if (!head) tail = nullptr; 
-    
-    delete toDelete;
-    --length;
+    eraseNode(head);
 }
 
 template <typename T>
 void LinkedList<T>::RemoveLast() {
-    if (!head) throw std::runtime_error("List is empty");
-    
-    if (head == tail) { 
-        delete head;
-        head = tail = nullptr;
-        length = 0;
-        return;
-    }
-    
-    Node *prev = head;
-    while (prev->next != tail) prev = prev->next; 
-    
-    delete tail;
-    tail = prev;
-    tail->next = nullptr;
-    --length;
+    if (!tail) throw std::runtime_error("List is empty");
+    eraseNode(tail);
 }
 
 template <typename T>
-bool LinkedList<T>::Remove(T item) {
-    if (!head) return false;
-    
-    if (head->data == item) {
-        RemoveFirst();
-        return true;
-    }
-    
-    Node *prev = head;
-    while (prev->next && prev->next->data != item) {
-        prev = prev->next;
-    }
-    
-    if (!prev->next) return false;  
-    
-    Node *toDelete = prev->next;
-    prev->next = toDelete->next;
-    
-    if (toDelete == tail) tail = prev;
-    
-    delete toDelete;
-    --length;
+bool LinkedList<T>::Remove(const T &item) {
+    Node *p = head;
+    while (p && p->data != item) p = p->next;
+    if (!p) return false;
+    eraseNode(p);
     return true;
 }
 
@@ -199,9 +304,8 @@ LinkedList<T> *LinkedList<T>::GetSubList(int startIndex, int endIndex) const {
     if (startIndex < 0 || endIndex >= length || startIndex > endIndex)
         throw std::out_of_range("Invalid indices");
 
-    auto *sub = new LinkedList<T>();
-    Node *p = head;
-    for (int i = 0; i < startIndex; ++i) p = p->next;
+    auto *sub = new LinkedList<T>(resource);
+    Node *p = nodeAt(startIndex);
     for (int i = startIndex; i <= endIndex; ++i) {
         sub->Append(p->data);
         p = p->next;
@@ -216,6 +320,29 @@ LinkedList<T> *LinkedList<T>::Concat(LinkedList<T> *other) const {
     return result;
 }
 
+// Переносит узлы other в конец списка за O(1), other становится пустым.
+// Узлы перевешиваются всегда: пул этого списка принимает блоки пула other,
+// поэтому перенесённые узлы остаются действительными и после уничтожения
+// other, а при удалении возвращаются в пул этого списка. Новые узлы
+// по-прежнему берутся из ресурса этого списка
+template <typename T>
+void LinkedList<T>::SpliceBack(LinkedList<T> &other) {
+    if (this == &other) throw std::invalid_argument("Cannot splice a list into itself");
+    if (!other.head) return;
+
+    GetPool()->Adopt(*other.pool);
+    if (head) {
+        tail->next = other.head;
+        other.head->prev = tail;
+    } else {
+        head = other.head;
+    }
+    tail = other.tail;
+    length += other.length;
+    other.head = other.tail = nullptr;
+    other.length = 0;
+}
+
 // int main() {
 //     int arr[] = {1,2,3};
 //     LinkedList<int> a(arr, 3);
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+// Монотонная арена поверх std::pmr::monotonic_buffer_resource: deallocate
+// ничего не делает, всё освобождается разом в Release(). Сверх стандартной
+// арены считает выданные байты. Объекты в арене нужно уничтожить до Release()
+class ArenaResource : public std::pmr::monotonic_buffer_resource {
+public:
+    explicit ArenaResource(std::size_t initialChunkSize = 64 * 1024,
+                           std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+        : std::pmr::monotonic_buffer_resource(initialChunkSize, upstream) {}
+
+    void Release() {
+        release();
+        used = 0;
+    }
+
+    std::size_t GetUsedBytes() const { return used; }
+
+protected:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void *result = std::pmr::monotonic_buffer_resource::do_allocate(bytes, alignment);
+        used += bytes;
+        return result;
+    }
+
+private:
+    std::size_t used = 0;
+};
+
+// Пул блоков по классам размеров для одного потока; освобождённые блоки
+// выдаются повторно, release() возвращает всю память в upstream
+using PoolResource = std::pmr::unsynchronized_pool_resource;
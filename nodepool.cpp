@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Пул узлов одного типа: узлы нарезаются подряд из блоков растущего размера,
+// освобождённые узлы попадают в список свободных и выдаются повторно.
+// Блоки возвращаются в memory_resource, когда их не держит ни один пул.
+// Пул может использоваться несколькими списками одного потока.
+template <typename Node>
+class NodePool {
+public:
+    explicit NodePool(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : resource(resource), storage(std::make_shared<Storage>(resource)) {}
+
+    NodePool(const NodePool &) = delete;
+    NodePool &operator=(const NodePool &) = delete;
+
+    // Узлы other могут перейти в списки этого пула: пул продлевает жизнь
+    // блокам other (и тем, что other принял сам), а освобождённые чужие
+    // узлы кладёт в свой список свободных
+    void Adopt(const NodePool &other) {
+        if (&other == this) return;
+        keep(other.storage);
+        for (const auto &borrowed : other.adopted) keep(borrowed);
+    }
+
+    // Память под один узел, без конструирования
+    void *Allocate() {
+        if (freeList) {
+            Slot *slot = freeList;
+            freeList = slot->next;
+            return slot;
+        }
+        if (!storage->blocks || used == storage->blocks->count) addBlock();
+        return slotsOf(storage->blocks) + used++;
+    }
+
+    void Deallocate(void *node) {
+        Slot *slot = static_cast<Slot *>(node);
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+    int GetBlockCount() const { return blockCount; }
+    std::pmr::memory_resource *GetResource() const { return resource; }
+
+private:
+    static constexpr int FirstBlockNodes = 16;
+    static constexpr int MaxBlockBytes   = 64 * 1024;
+
+    union Slot {
+        Slot *next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    struct Block {
+        Block *next;
+        int    count;
+    };
+
+    // Блоки одного пула. Разделяются через shared_ptr с пулами, принявшими
+    // их узлы, поэтому узел живёт, пока жив хоть один такой пул
+    struct Storage {
+        std::pmr::memory_resource *resource;
+        Block                     *blocks = nullptr;
+
+        explicit Storage(std::pmr::memory_resource *resource) : resource(resource) {}
+        Storage(const Storage &) = delete;
+        Storage &operator=(const Storage &) = delete;
+
+        ~Storage() {
+            while (blocks) {
+                Block *next = blocks->next;
+                resource->deallocate(blocks, bytesFor(blocks->count), alignment());
+                blocks = next;
+            }
+        }
+    };
+
+    std::pmr::memory_resource             *resource;
+    std::shared_ptr<Storage>               storage;
+    std::vector<std::shared_ptr<Storage>>  adopted;
+    Slot  *freeList   = nullptr;
+    int    used       = 0;
+    int    blockCount = 0;
+
+    static std::size_t alignment() { return std::max(alignof(Block), alignof(Slot)); }
+
+    static std::size_t slotsOffset() {
+        return (sizeof(Block) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+    }
+
+    static std::size_t bytesFor(int count) { return slotsOffset() + count * sizeof(Slot); }
+
+    static int maxBlockNodes() {
+        return std::max<int>(FirstBlockNodes, MaxBlockBytes / static_cast<int>(sizeof(Slot)));
+    }
+
+    static Slot *slotsOf(Block *block) {
+        return reinterpret_cast<Slot *>(reinterpret_cast<char *>(block) + slotsOffset());
+    }
+
+    void keep(const std::shared_ptr<Storage> &other) {
+        if (other == storage || std::find(adopted.begin(), adopted.end(), other) != adopted.end()) return;
+        adopted.push_back(other);
+    }
+
+    void addBlock() {
+        Block *&blocks = storage->blocks;
+        int count = blocks ? std::min(blocks->count * 2, maxBlockNodes()) : FirstBlockNodes;
+        auto *block  = static_cast<Block *>(resource->allocate(bytesFor(count), alignment()));
+        block->next  = blocks;
+        block->count = count;
+        blocks       = block;
+        used         = 0;
+        ++blockCount;
+    }
+};
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+#include "memoryresource.cpp"
+
+// Неизменяемое AVL-дерево по позициям: каждая операция возвращает новое дерево,
+// копируя только путь от корня до места изменения (O(log n) узлов), остальные
+// узлы общие для всех версий. Копия дерева - это копия указателя на корень.
+// Вставка, слияние и срез строятся на split/join, каждая за O(log n).
+// Узлы размещаются в memory_resource; он должен жить дольше всех версий
+template <typename T>
+class PersistentTree {
+public:
+    explicit PersistentTree(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : resource(resource) {}
+
+    // Сбалансированное дерево из count элементов, начиная с first, за O(n)
+    template <typename Iterator>
+    static PersistentTree Build(Iterator first, int count,
+                                std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+    {
+        if (count < 0) throw std::invalid_argument("Count cannot be negative");
+        PersistentTree tree(resource);
+        tree.root = tree.build(first, count);
+        return tree;
+    }
+
+    int GetLength() const { return sizeOf(root); }
+    std::pmr::memory_resource *GetResource() const { return resource; }
+
+    const T &Get(int index) const {
+        if (index < 0 || index >= GetLength()) throw std::out_of_range("Index out of range");
+        const Node *node = root.get();
+        for (;;) {
+            int leftSize = sizeOf(node->left);
+            if (index == leftSize) return node->value;
+            if (index < leftSize) node = node->left.get();
+            else {
+                index -= leftSize + 1;
+                node = node->right.get();
+            }
+        }
+    }
+
+    PersistentTree Insert(int index, T item) const {
+        if (index < 0 || index > GetLength()) throw std::out_of_range("Index out of range");
+        auto [left, right] = split(root, index);
+        return withRoot(join(left, std::move(item), right));
+    }
+
+    PersistentTree Concat(const PersistentTree &other) const {
+        if (!other.root) return *this;
+        if (!root) return withRoot(other.root);
+        auto [first, rest] = split(other.root, 1);
+        return withRoot(join(root, first->value, rest));
+    }
+
+    // Элементы с l по r включительно
+    PersistentTree Slice(int l, int r) const {
+        if (l < 0 || r >= GetLength() || l > r) throw std::out_of_range("Invalid indices");
+        Ref tail = split(root, l).second;
+        return withRoot(split(tail, r - l + 1).first);
+    }
+
+    template <typename Action>
+    void ForEach(Action &&action) const { forEach(root.get(), action); }
+
+private:
+    struct Node;
+    using Ref = std::shared_ptr<const Node>;
+
+    struct Node {
+        T   value;
+        Ref left;
+        Ref right;
+        int height;
+        int size;
+
+        template <typename U>
+        Node(Ref left, U &&value, Ref right)
+            : value(std::forward<U>(value)), left(std::move(left)), right(std::move(right)),
+              height(1 + std::max(heightOf(this->left), heightOf(this->right))),
+              size(1 + sizeOf(this->left) + sizeOf(this->right)) {}
+    };
+
+    Ref root;
+    std::pmr::memory_resource *resource;
+
+    static int heightOf(const Ref &node) { return node ? node->height : 0; }
+    static int sizeOf(const Ref &node)   { return node ? node->size : 0; }
+
+    PersistentTree withRoot(Ref newRoot) const {
+        PersistentTree tree(resource);
+        tree.root = std::move(newRoot);
+        return tree;
+    }
+
+    template <typename U>
+    Ref make(Ref left, U &&value, Ref right) const {
+        return std::allocate_shared<Node>(std::pmr::polymorphic_allocator<Node>(resource),
+                                          std::move(left), std::forward<U>(value), std::move(right));
+    }
+
+    template <typename Iterator>
+    Ref build(Iterator &first, int count) const {
+        if (count == 0) return nullptr;
+        Ref left = build(first, count / 2);
+        T value = *first;
+        ++first;
+        Ref right = build(first, count - count / 2 - 1);
+        return make(std::move(left), std::move(value), std::move(right));
+    }
+
+    // Узел из поддеревьев, высоты которых отличаются не больше чем на 2
+    template <typename U>
+    Ref balance(const Ref &left, U &&value, const Ref &right) const {
+        int hl = heightOf(left);
+        int hr = heightOf(right);
+        if (hl > hr + 1) {
+            if (heightOf(left->left) >= heightOf(left->right))
+                return make(left->left, left->value, make(left->right, std::forward<U>(value), right));
+            const Ref &mid = left->right;
+            return make(make(left->left, left->value, mid->left), mid->value, make(mid->right, std::forward<U>(value), right));
+        }
+        if (hr > hl + 1) {
+            if (heightOf(right->right) >= heightOf(right->left))
+                return make(make(left, std::forward<U>(value), right->left), right->value, right->right);
+            const Ref &mid = right->left;
+            return make(make(left, std::forward<U>(value), mid->left), mid->value, make(mid->right, right->value, right->right));
+        }
+        return make(left, std::forward<U>(value), right);
+    }
+
+    // Все элементы left, затем value, затем элементы right; O(|h(left) - h(right)|)
+    template <typename U>
+    Ref join(const Ref &left, U &&value, const Ref &right) const {
+        int hl = heightOf(left);
+        int hr = heightOf(right);
+        if (hl > hr + 1) return balance(left->left, left->value, join(left->right, std::forward<U>(value), right));
+        if (hr > hl + 1) return balance(join(left, std::forward<U>(value), right->left), right->value, right->right);
+        return make(left, std::forward<U>(value), right);
+    }
+
+    // Первые count элементов и остаток
+    std::pair<Ref, Ref> split(const Ref &node, int count) const {
+        if (!node) return {nullptr, nullptr};
+        int leftSize = sizeOf(node->left);
+        if (count <= leftSize) {
+            auto [left, right] = split(node->left, count);
+            return {left, join(right, node->value, node->right)};
+        }
+        auto [left, right] = split(node->right, count - leftSize - 1);
+        return {join(node->left, node->value, left), right};
+    }
+
+    template <typename Action>
+    static void forEach(const Node *node, Action &action) {
+        while (node) {
+            forEach(node->left.get(), action);
+            action(node->value);
+            node = node->right.get();
+        }
+    }
+};
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "indexiterator.cpp"
+#include "memoryresource.cpp"
+
+// Кольцевой буфер: элементы занимают позиции head, head + 1, ... по модулю
+// ёмкости, поэтому вставка и удаление на обоих концах - амортизированно O(1).
+// Ёмкость - степень двойки, позиция вычисляется маской. Слоты вне этого
+// окна объектов не содержат; блок выделяется в memory_resource
+template <typename T>
+class RingBuffer {
+private:
+    T  *data      = nullptr;
+    int capacity  = 0;
+    int head      = 0;
+    int size      = 0;
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource();
+
+    int slot(int i) const { return (head + i) & (capacity - 1); }
+
+    T *allocate(int count) const {
+        if (count == 0) return nullptr;
+        return static_cast<T *>(resource->allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    void deallocate(T *memory, int count) {
+        if (memory) resource->deallocate(memory, sizeof(T) * count, alignof(T));
+    }
+
+    static int roundUp(int count) {
+        int result = count > 0 ? 1 : 0;
+        while (result < count) result *= 2;
+        return result;
+    }
+
+    // Переносит элементы в новый блок, начиная с его позиции 0
+    void moveTo(T *target) {
+        for (int i = 0; i < size; ++i) {
+            T &item = data[slot(i)];
+            new (target + i) T(std::move(item));
+            item.~T();
+        }
+        deallocate(data, capacity);
+        data = target;
+        head = 0;
+    }
+
+    void reallocate(int new_capacity) {
+        T *tmp = allocate(new_capacity);
+        moveTo(tmp);
+        capacity = new_capacity;
+    }
+
+    // Блок удваивается. Новый элемент создаётся в нём раньше, чем туда
+    // переедут старые, так что EmplaceBack(buffer[0]) безопасен
+    template <typename... Args>
+    void growAndEmplace(bool atFront, Args &&...args) {
+        int new_capacity = capacity ? capacity * 2 : 1;
+        T *tmp = allocate(new_capacity);
+        T *item = tmp + (atFront ? new_capacity - 1 : size);
+        try {
+            new (item) T(std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(tmp, new_capacity);
+            throw;
+        }
+        moveTo(tmp);
+        capacity = new_capacity;
+        if (atFront) head = new_capacity - 1;
+        ++size;
+    }
+
+    void destroyAll() {
+        for (int i = 0; i < size; ++i) data[slot(i)].~T();
+        size = 0;
+        head = 0;
+    }
+
+    void copyFrom(const RingBuffer &other) {
+        data     = allocate(other.capacity);
+        capacity = other.capacity;
+        for (; size < other.size; ++size) new (data + size) T(other[size]);
+    }
+
+public:
+    using Iterator      = IndexIterator<RingBuffer, T, false>;
+    using ConstIterator = IndexIterator<RingBuffer, T, true>;
+
+    RingBuffer() = default;
+
+    explicit RingBuffer(std::pmr::memory_resource *resource) : resource(resource) {}
+
+    RingBuffer(const T *items, int count, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : resource(resource)
+    {
+        if (count < 0) throw std::invalid_argument("Count cannot be negative");
+        data     = allocate(roundUp(count));
+        capacity = roundUp(count);
+        std::uninitialized_copy(items, items + count, data);
+        size     = count;
+    }
+
+    // Копия лежит в новом блоке с позиции 0 и наследует ресурс источника,
+    // присваивание копией сохраняет свой ресурс
+    RingBuffer(const RingBuffer &other) : RingBuffer(other.resource) { copyFrom(other); }
+
+    RingBuffer &operator=(const RingBuffer &other) {
+        if (this == &other) return *this;
+        RingBuffer copy(resource);
+        copy.copyFrom(other);
+        *this = std::move(copy);
+        return *this;
+    }
+
+    RingBuffer(RingBuffer &&other) noexcept
+        : data(other.data), capacity(other.capacity), head(other.head), size(other.size), resource(other.resource)
+    {
+        other.data     = nullptr;
+        other.capacity = 0;
+        other.head     = 0;
+        other.size     = 0;
+    }
+
+    RingBuffer &operator=(RingBuffer &&other) noexcept {
+        if (this == &other) return *this;
+        destroyAll();
+        deallocate(data, capacity);
+        data     = other.data;
+        capacity = other.capacity;
+        head     = other.head;
+        size     = other.size;
+        resource = other.resource;
+        other.data     = nullptr;
+        other.capacity = 0;
+        other.head     = 0;
+        other.size     = 0;
+        return *this;
+    }
+
+    ~RingBuffer() {
+        destroyAll();
+        deallocate(data, capacity);
+    }
+
+    void Reserve(int new_capacity) { if (new_capacity > capacity) reallocate(roundUp(new_capacity)); }
+
+    T Get(int index) const {
+        if (index < 0 || index >= size) throw std::out_of_range("Index out of range");
+        return data[slot(index)];
+    }
+
+    T &operator[](int index) { return data[slot(index)]; }
+    const T &operator[](int index) const { return data[slot(index)]; }
+
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args) {
+        if (size == capacity) growAndEmplace(false, std::forward<Args>(args)...);
+        else {
+            new (data + slot(size)) T(std::forward<Args>(args)...);
+            ++size;
+        }
+        return (*this)[size - 1];
+    }
+
+    template <typename... Args>
+    T &EmplaceFront(Args &&...args) {
+        if (size == capacity) growAndEmplace(true, std::forward<Args>(args)...);
+        else {
+            int first = (head - 1) & (capacity - 1);
+            new (data + first) T(std::forward<Args>(args)...);
+            head = first;
+            ++size;
+        }
+        return data[head];
+    }
+
+    void Append(const T &item)  { EmplaceBack(item); }
+    void Append(T &&item)       { EmplaceBack(std::move(item)); }
+    void Prepend(const T &item) { EmplaceFront(item); }
+    void Prepend(T &&item)      { EmplaceFront(std::move(item)); }
+
+    // Вставка сдвигает меньшую из двух частей буфера
+    template <typename... Args>
+    T &EmplaceAt(int index, Args &&...args) {
+        if (index < 0 || index > size) throw std::out_of_range("Index out of range");
+        if (index == size) return EmplaceBack(std::forward<Args>(args)...);
+        if (index == 0) return EmplaceFront(std::forward<Args>(args)...);
+
+        T item(std::forward<Args>(args)...);
+        if (index < size / 2) {
+            EmplaceFront(std::move((*this)[0]));
+            for (int j = 1; j < index; ++j) (*this)[j] = std::move((*this)[j + 1]);
+        } else {
+            EmplaceBack(std::move((*this)[size - 1]));
+            for (int j = size - 2; j > index; --j) (*this)[j] = std::move((*this)[j - 1]);
+        }
+        (*this)[index] = std::move(item);
+        return (*this)[index];
+    }
+
+    T PopFront() {
+        if (size == 0) throw std::out_of_range("Buffer is empty");
+        T &first = data[head];
+        T result = std::move(first);
+        first.~T();
+        head = slot(1);
+        --size;
+        return result;
+    }
+
+    T PopBack() {
+        if (size == 0) throw std::out_of_range("Buffer is empty");
+        T &last = (*this)[size - 1];
+        T result = std::move(last);
+        last.~T();
+        --size;
+        return result;
+    }
+
+    // Удаление сдвигает меньшую из двух частей буфера
+    T RemoveAt(int index) {
+        if (index < 0 || index >= size) throw std::out_of_range("Index out of range");
+        T result = std::move((*this)[index]);
+        if (index < size / 2) {
+            for (int j = index; j > 0; --j) (*this)[j] = std::move((*this)[j - 1]);
+            data[head].~T();
+            head = slot(1);
+        } else {
+            for (int j = index; j < size - 1; ++j) (*this)[j] = std::move((*this)[j + 1]);
+            (*this)[size - 1].~T();
+        }
+        --size;
+        return result;
+    }
+
+    // Элементы подряд в порядке индексов; если буфер перевёрнут через конец
+    // блока, он переносится в новый блок той же ёмкости
+    T *Linearize() {
+        if (head + size > capacity) moveTo(allocate(capacity));
+        return data + head;
+    }
+
+    Iterator      begin()       { return Iterator(this, 0); }
+    Iterator      end()         { return Iterator(this, size); }
+    ConstIterator begin() const { return ConstIterator(this, 0); }
+    ConstIterator end()   const { return ConstIterator(this, size); }
+
+    int GetSize() const { return size; }
+    int GetCapacity() const { return capacity; }
+    std::pmr::memory_resource *GetResource() const { return resource; }
+};
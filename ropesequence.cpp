@@ -0,0 +1,586 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "sequence.cpp"
+
+// Число элементов в листе по умолчанию: около 512 байт данных, но не меньше 8
+template <typename T>
+constexpr int RopeLeafCapacity() {
+    return sizeof(T) >= 64 ? 8 : static_cast<int>(512 / sizeof(T));
+}
+
+// Верёвка: AVL-дерево, в листьях которого лежат куски до C элементов подряд.
+// Поиск по индексу, вставка, удаление, Split и SpliceBack - O(log n).
+// Полный лист при вставке делится, опустевший лист удаляется, при слиянии
+// деревьев соседние малые листья объединяются. Итераторы и ForEach идут
+// по листу без спуска от корня, переход к следующему листу - O(log n).
+// Узлы берутся из memory_resource
+template <typename T, int C = RopeLeafCapacity<T>()>
+class RopeSequence : public MutableSequence<T> {
+    static_assert(C >= 2, "Leaf capacity must be at least 2");
+
+    // Лист имеет высоту 0, у пустого поддерева высота -1
+    struct Node {
+        int size;
+        int height;
+    };
+
+    struct Internal : Node {
+        Node *left;
+        Node *right;
+    };
+
+    struct Leaf : Node {
+        alignas(T) unsigned char storage[C * sizeof(T)];
+
+        T *Items() { return std::launder(reinterpret_cast<T *>(storage)); }
+        const T *Items() const { return std::launder(reinterpret_cast<const T *>(storage)); }
+    };
+
+public:
+    // Итератор произвольного доступа: лист, индекс его первого элемента и позиция.
+    // Шаги внутри листа - O(1), выход за лист ищет новый лист от корня.
+    // Любое изменение верёвки делает итераторы недействительными
+    template <bool IsConst>
+    class BasicIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = std::conditional_t<IsConst, const T *, T *>;
+        using reference         = std::conditional_t<IsConst, const T &, T &>;
+
+        BasicIterator() = default;
+
+        template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+        BasicIterator(const BasicIterator<OtherConst> &other)
+            : rope(other.rope), leaf(other.leaf), leafStart(other.leafStart), position(other.position) {}
+
+        reference operator*() const  { return leaf->Items()[position - leafStart]; }
+        pointer   operator->() const { return leaf->Items() + (position - leafStart); }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        BasicIterator &operator++() {
+            if (++position - leafStart == leaf->size) seek(position);
+            return *this;
+        }
+
+        BasicIterator &operator--() {
+            if (!leaf || position == leafStart) seek(position - 1);
+            else --position;
+            return *this;
+        }
+
+        BasicIterator operator++(int) { BasicIterator old = *this; ++*this; return old; }
+        BasicIterator operator--(int) { BasicIterator old = *this; --*this; return old; }
+
+        BasicIterator &operator+=(difference_type n) {
+            if (leaf && position + n >= leafStart && position + n < leafStart + leaf->size) position += n;
+            else seek(position + n);
+            return *this;
+        }
+
+        BasicIterator &operator-=(difference_type n) { return *this += -n; }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type n) { return it += n; }
+        friend BasicIterator operator+(difference_type n, BasicIterator it) { return it += n; }
+        friend BasicIterator operator-(BasicIterator it, difference_type n) { return it -= n; }
+
+        difference_type operator-(const BasicIterator &other) const { return position - other.position; }
+
+        bool operator==(const BasicIterator &other) const { return position == other.position; }
+        bool operator!=(const BasicIterator &other) const { return position != other.position; }
+        bool operator<(const BasicIterator &other) const  { return position < other.position; }
+        bool operator>(const BasicIterator &other) const  { return position > other.position; }
+        bool operator<=(const BasicIterator &other) const { return position <= other.position; }
+        bool operator>=(const BasicIterator &other) const { return position >= other.position; }
+
+    private:
+        friend class RopeSequence;
+        template <bool> friend class BasicIterator;
+
+        const RopeSequence *rope      = nullptr;
+        Leaf               *leaf      = nullptr;
+        int                 leafStart = 0;
+        int                 position  = 0;
+
+        BasicIterator(const RopeSequence *rope, int index) : rope(rope) { seek(index); }
+
+        void seek(int index) {
+            position = index;
+            if (index == rope->GetLength()) {
+                leaf = nullptr;
+                leafStart = index;
+                return;
+            }
+            auto [found, start] = rope->locate(index);
+            leaf = found;
+            leafStart = start;
+        }
+    };
+
+    using Iterator      = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    RopeSequence() = default;
+
+    explicit RopeSequence(std::pmr::memory_resource *resource) : resource(resource) {}
+
+    RopeSequence(T *items, int n, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : resource(resource)
+    {
+        if (n < 0) throw std::invalid_argument("Count cannot be negative");
+        root = build(items, n);
+    }
+
+    // Копия повторяет форму дерева оригинала
+    RopeSequence(const RopeSequence &other) : resource(other.resource) { root = clone(other.root); }
+
+    RopeSequence(RopeSequence &&other) noexcept : root(other.root), resource(other.resource) { other.root = nullptr; }
+
+    RopeSequence &operator=(const RopeSequence &other) {
+        if (this == &other) return *this;
+        Node *copy = clone(other.root);
+        destroyTree(root);
+        root = copy;
+        return *this;
+    }
+
+    RopeSequence &operator=(RopeSequence &&other) noexcept {
+        if (this == &other) return *this;
+        destroyTree(root);
+        root = other.root;
+        resource = other.resource;
+        other.root = nullptr;
+        return *this;
+    }
+
+    ~RopeSequence() { destroyTree(root); }
+
+    T GetFirst() const override {
+        if (!root) throw std::out_of_range("Sequence is empty");
+        return *begin();
+    }
+    T GetLast() const override {
+        if (!root) throw std::out_of_range("Sequence is empty");
+        return *std::prev(end());
+    }
+    T Get(int i) const override {
+        if (i < 0 || i >= GetLength()) throw std::out_of_range("Index out of range");
+        auto [leaf, start] = locate(i);
+        return leaf->Items()[i - start];
+    }
+    int GetLength() const override { return root ? root->size : 0; }
+    std::pmr::memory_resource *GetResource() const { return resource; }
+
+    Sequence<T>* GetSubsequence(int l, int r) const override {
+        if (l < 0 || r >= GetLength() || l > r) throw std::out_of_range("Invalid indices");
+        auto *sub = new RopeSequence(resource);
+        try {
+            sub->root = sub->build(begin() + l, r - l + 1);
+        } catch (...) {
+            delete sub;
+            throw;
+        }
+        return sub;
+    }
+    SequenceView<T, RopeSequence> GetSlice(int l, int r) const { return SequenceView<T, RopeSequence>(*this, l, r); }
+
+    Sequence<T>* Append(T item) const override {
+        auto *copy = new RopeSequence(*this);
+        copy->AppendInPlace(std::move(item));
+        return copy;
+    }
+    Sequence<T>* Prepend(T item) const override {
+        auto *copy = new RopeSequence(*this);
+        copy->PrependInPlace(std::move(item));
+        return copy;
+    }
+    Sequence<T>* InsertAt(T item, int idx) const override {
+        if (idx < 0 || idx > GetLength()) throw std::out_of_range("Index out of range");
+        auto *copy = new RopeSequence(*this);
+        copy->InsertAtInPlace(std::move(item), idx);
+        return copy;
+    }
+    // Элементы other собираются в массив, из него за O(m) строится
+    // сбалансированное дерево, которое присоединяется за O(log n)
+    Sequence<T>* Concat(Sequence<T>* other) const override {
+        DynamicArray<T> items;
+        items.Reserve(other->GetLength());
+        other->ForEach([&items](const T &item) { items.Append(item); });
+        auto *res = new RopeSequence(*this);
+        try {
+            res->root = res->join(res->root, res->build(items.begin(), items.GetSize()));
+        } catch (...) {
+            delete res;
+            throw;
+        }
+        return res;
+    }
+
+    void ForEach(const std::function<void(const T &)> &action) const override { forEach(root, action); }
+
+    void AppendInPlace(const T &item) override { EmplaceBack(item); }
+    void AppendInPlace(T &&item) override { EmplaceBack(std::move(item)); }
+    void PrependInPlace(const T &item) override { EmplaceAt(0, item); }
+    void PrependInPlace(T &&item) override { EmplaceAt(0, std::move(item)); }
+    void InsertAtInPlace(const T &item, int idx) override { EmplaceAt(idx, item); }
+    void InsertAtInPlace(T &&item, int idx) override { EmplaceAt(idx, std::move(item)); }
+
+    template <typename... Args>
+    void EmplaceBack(Args &&...args) { EmplaceAt(GetLength(), std::forward<Args>(args)...); }
+
+    template <typename... Args>
+    void EmplaceAt(int idx, Args &&...args) {
+        if (idx < 0 || idx > GetLength()) throw std::out_of_range("Index out of range");
+        T item(std::forward<Args>(args)...);
+        if (!root) {
+            Leaf *leaf = createLeaf();
+            new (leaf->Items()) T(std::move(item));
+            leaf->size = 1;
+            root = leaf;
+            return;
+        }
+        root = insert(root, idx, item);
+    }
+
+    T RemoveAt(int idx) {
+        if (idx < 0 || idx >= GetLength()) throw std::out_of_range("Index out of range");
+        T result = std::move(*(begin() + idx));
+        root = erase(root, idx);
+        return result;
+    }
+
+    // Оставляет элементы [0, idx), остальные возвращает новой верёвкой; O(log n)
+    RopeSequence Split(int idx) {
+        if (idx < 0 || idx > GetLength()) throw std::out_of_range("Index out of range");
+        auto [left, right] = split(root, idx);
+        root = left;
+        RopeSequence tail(resource);
+        tail.root = right;
+        return tail;
+    }
+
+    // Присоединяет дерево other в конец за O(log n), other становится пустым.
+    // Узлы из несовместимого ресурса не переносятся - элементы копируются
+    void SpliceBack(RopeSequence &other) {
+        if (this == &other) throw std::invalid_argument("Cannot splice a rope into itself");
+        if (!resource->is_equal(*other.resource)) {
+            for (T &item : other) EmplaceBack(std::move(item));
+            other = RopeSequence(other.resource);
+            return;
+        }
+        root = join(root, other.root);
+        other.root = nullptr;
+    }
+
+    void AppendMoved(RopeSequence &&other) { SpliceBack(other); }
+
+    Iterator      begin()       { return Iterator(this, 0); }
+    Iterator      end()         { return Iterator(this, GetLength()); }
+    ConstIterator begin() const { return ConstIterator(this, 0); }
+    ConstIterator end()   const { return ConstIterator(this, GetLength()); }
+
+private:
+    Node *root = nullptr;
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource();
+
+    static bool      isLeaf(const Node *node)  { return node->height == 0; }
+    static Leaf     *asLeaf(Node *node)        { return static_cast<Leaf *>(node); }
+    static Internal *asInternal(Node *node)    { return static_cast<Internal *>(node); }
+    static int       heightOf(const Node *node) { return node ? node->height : -1; }
+
+    Leaf *createLeaf() {
+        Leaf *leaf = new (resource->allocate(sizeof(Leaf), alignof(Leaf))) Leaf;
+        leaf->size = 0;
+        leaf->height = 0;
+        return leaf;
+    }
+
+    Internal *createInternal(Node *left, Node *right) {
+        Internal *node = new (resource->allocate(sizeof(Internal), alignof(Internal))) Internal;
+        node->left = left;
+        node->right = right;
+        update(node);
+        return node;
+    }
+
+    void destroyNode(Node *node) {
+        if (isLeaf(node)) {
+            Leaf *leaf = asLeaf(node);
+            std::destroy(leaf->Items(), leaf->Items() + leaf->size);
+            leaf->~Leaf();
+            resource->deallocate(leaf, sizeof(Leaf), alignof(Leaf));
+        } else {
+            Internal *internal = asInternal(node);
+            internal->~Internal();
+            resource->deallocate(internal, sizeof(Internal), alignof(Internal));
+        }
+    }
+
+    void destroyTree(Node *node) {
+        if (!node) return;
+        if (!isLeaf(node)) {
+            destroyTree(asInternal(node)->left);
+            destroyTree(asInternal(node)->right);
+        }
+        destroyNode(node);
+    }
+
+    static void update(Internal *node) {
+        node->size = node->left->size + node->right->size;
+        node->height = 1 + std::max(node->left->height, node->right->height);
+    }
+
+    static Internal *rotateLeft(Internal *node) {
+        Internal *right = asInternal(node->right);
+        node->right = right->left;
+        update(node);
+        right->left = node;
+        update(right);
+        return right;
+    }
+
+    static Internal *rotateRight(Internal *node) {
+        Internal *left = asInternal(node->left);
+        node->left = left->right;
+        update(node);
+        left->right = node;
+        update(left);
+        return left;
+    }
+
+    // Высоты детей отличаются не больше чем на 2
+    static Node *rebalance(Internal *node) {
+        update(node);
+        int balance = node->left->height - node->right->height;
+        if (balance > 1) {
+            Internal *left = asInternal(node->left);
+            if (heightOf(left->left) < heightOf(left->right)) node->left = rotateLeft(left);
+            return rotateRight(node);
+        }
+        if (balance < -1) {
+            Internal *right = asInternal(node->right);
+            if (heightOf(right->right) < heightOf(right->left)) node->right = rotateRight(right);
+            return rotateLeft(node);
+        }
+        return node;
+    }
+
+    // Лист с index-м элементом и индекс первого элемента листа
+    std::pair<Leaf *, int> locate(int index) const {
+        Node *node = root;
+        int start = 0;
+        while (!isLeaf(node)) {
+            Internal *internal = asInternal(node);
+            if (index < internal->left->size) {
+                node = internal->left;
+            } else {
+                index -= internal->left->size;
+                start += internal->left->size;
+                node = internal->right;
+            }
+        }
+        return {asLeaf(node), start};
+    }
+
+    // Вставка в лист со свободным местом: сдвиг хвоста листа на одну позицию
+    static void insertInLeaf(Leaf *leaf, int offset, T &item) {
+        T *items = leaf->Items();
+        if (offset == leaf->size) {
+            new (items + offset) T(std::move(item));
+        } else {
+            new (items + leaf->size) T(std::move(items[leaf->size - 1]));
+            std::move_backward(items + offset, items + leaf->size - 1, items + leaf->size);
+            items[offset] = std::move(item);
+        }
+        ++leaf->size;
+    }
+
+    // Полный лист делится пополам; вставка в край листа заводит новый лист,
+    // поэтому последовательная запись заполняет листья целиком
+    Node *insert(Node *node, int index, T &item) {
+        if (isLeaf(node)) {
+            Leaf *leaf = asLeaf(node);
+            if (leaf->size < C) {
+                insertInLeaf(leaf, index, item);
+                return leaf;
+            }
+            Leaf *fresh = createLeaf();
+            if (index == 0 || index == C) {
+                new (fresh->Items()) T(std::move(item));
+                fresh->size = 1;
+                return index == 0 ? createInternal(fresh, leaf) : createInternal(leaf, fresh);
+            }
+            int half = C / 2;
+            std::uninitialized_move(leaf->Items() + half, leaf->Items() + C, fresh->Items());
+            std::destroy(leaf->Items() + half, leaf->Items() + C);
+            leaf->size = half;
+            fresh->size = C - half;
+            if (index <= half) insertInLeaf(leaf, index, item);
+            else insertInLeaf(fresh, index - half, item);
+            return createInternal(leaf, fresh);
+        }
+
+        Internal *internal = asInternal(node);
+        int leftSize = internal->left->size;
+        if (index <= leftSize) internal->left = insert(internal->left, index, item);
+        else internal->right = insert(internal->right, index - leftSize, item);
+        return rebalance(internal);
+    }
+
+    // Возвращает поддерево без index-го элемента (nullptr, если оно опустело)
+    Node *erase(Node *node, int index) {
+        if (isLeaf(node)) {
+            Leaf *leaf = asLeaf(node);
+            T *items = leaf->Items();
+            std::move(items + index + 1, items + leaf->size, items + index);
+            std::destroy_at(items + leaf->size - 1);
+            if (--leaf->size > 0) return leaf;
+            destroyNode(leaf);
+            return nullptr;
+        }
+
+        Internal *internal = asInternal(node);
+        int leftSize = internal->left->size;
+        if (index < leftSize) internal->left = erase(internal->left, index);
+        else internal->right = erase(internal->right, index - leftSize);
+
+        Node *survivor = !internal->left ? internal->right : !internal->right ? internal->left : nullptr;
+        if (!internal->left || !internal->right) {
+            destroyNode(internal);
+            return survivor;
+        }
+        return rebalance(internal);
+    }
+
+    // Все элементы left, затем все элементы right
+    Node *join(Node *left, Node *right) {
+        if (!left) return right;
+        if (!right) return left;
+        if (left->height > right->height + 1) {
+            Internal *internal = asInternal(left);
+            internal->right = join(internal->right, right);
+            return rebalance(internal);
+        }
+        if (right->height > left->height + 1) {
+            Internal *internal = asInternal(right);
+            internal->left = join(left, internal->left);
+            return rebalance(internal);
+        }
+        if (isLeaf(left) && isLeaf(right) && left->size + right->size <= C) {
+            Leaf *target = asLeaf(left);
+            Leaf *source = asLeaf(right);
+            std::uninitialized_move(source->Items(), source->Items() + source->size, target->Items() + target->size);
+            target->size += source->size;
+            destroyNode(source);
+            return target;
+        }
+        return createInternal(left, right);
+    }
+
+    // Первые count элементов и остаток; внутренние узлы пути освобождаются
+    std::pair<Node *, Node *> split(Node *node, int count) {
+        if (!node) return {nullptr, nullptr};
+        if (isLeaf(node)) {
+            if (count == 0) return {nullptr, node};
+            if (count >= node->size) return {node, nullptr};
+            Leaf *leaf = asLeaf(node);
+            Leaf *rest = createLeaf();
+            std::uninitialized_move(leaf->Items() + count, leaf->Items() + leaf->size, rest->Items());
+            std::destroy(leaf->Items() + count, leaf->Items() + leaf->size);
+            rest->size = leaf->size - count;
+            leaf->size = count;
+            return {leaf, rest};
+        }
+
+        Internal *internal = asInternal(node);
+        Node *left = internal->left;
+        Node *right = internal->right;
+        destroyNode(internal);
+        if (count <= left->size) {
+            auto [first, second] = split(left, count);
+            return {first, join(second, right)};
+        }
+        auto [first, second] = split(right, count - left->size);
+        return {join(left, first), second};
+    }
+
+    // Сбалансированное дерево из count элементов с полными листьями
+    template <typename Input>
+    Node *build(Input first, int count) {
+        return count ? buildRange(first, count) : nullptr;
+    }
+
+    template <typename Input>
+    Node *buildRange(Input &first, int count) {
+        if (count <= C) {
+            Leaf *leaf = createLeaf();
+            try {
+                for (; leaf->size < count; ++leaf->size, ++first) new (leaf->Items() + leaf->size) T(*first);
+            } catch (...) {
+                destroyNode(leaf);
+                throw;
+            }
+            return leaf;
+        }
+        int leftCount = (count + C - 1) / C / 2 * C;
+        Node *left = buildRange(first, leftCount);
+        Node *right = nullptr;
+        try {
+            right = buildRange(first, count - leftCount);
+            return createInternal(left, right);
+        } catch (...) {
+            destroyTree(left);
+            destroyTree(right);
+            throw;
+        }
+    }
+
+    Node *clone(const Node *node) {
+        if (!node) return nullptr;
+        if (node->height == 0) {
+            const Leaf *source = static_cast<const Leaf *>(node);
+            Leaf *leaf = createLeaf();
+            try {
+                std::uninitialized_copy(source->Items(), source->Items() + source->size, leaf->Items());
+            } catch (...) {
+                destroyNode(leaf);
+                throw;
+            }
+            leaf->size = source->size;
+            return leaf;
+        }
+        const Internal *source = static_cast<const Internal *>(node);
+        Node *left = clone(source->left);
+        Node *right = nullptr;
+        try {
+            right = clone(source->right);
+            return createInternal(left, right);
+        } catch (...) {
+            destroyTree(left);
+            destroyTree(right);
+            throw;
+        }
+    }
+
+    template <typename Action>
+    static void forEach(const Node *node, Action &action) {
+        while (node && node->height > 0) {
+            const Internal *internal = static_cast<const Internal *>(node);
+            forEach(internal->left, action);
+            node = internal->right;
+        }
+        if (!node) return;
+        const Leaf *leaf = static_cast<const Leaf *>(node);
+        for (const T *item = leaf->Items(); item != leaf->Items() + leaf->size; ++item) action(*item);
+    }
+};
@@ -1,171 +1,1057 @@
 #include <iostream>
+#include <string>
 #include <functional>
 #include <stdexcept>
 #include <algorithm>
+#include <cstddef>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include "sequence.cpp"
+#include "ropesequence.cpp"
+#include "gapbuffersequence.cpp"
 
+// Значение параметра N, при котором ёмкость сегмента задаётся во время выполнения
+constexpr int DynamicSegmentCapacity = 0;
+
+// Ёмкость по умолчанию: степень двойки, чтобы сегмент занимал около страницы памяти
 template <typename T>
+constexpr int DefaultSegmentCapacity()
+{
+    int capacity = 16;
+    while (capacity * 2 * sizeof(T) <= 4096)
+    {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+// SegmentedDeque - ёмкость сегмента задаётся в конструкторе,
+// SegmentedDeque<T, N> - ёмкость N известна при компиляции; для степени двойки
+// индекс переводится в сегмент сдвигами и масками
+template <typename T, int N = DynamicSegmentCapacity>
 class SegmentedDeque : public MutableSequence<T>
 {
 private:
+    static_assert(N >= 0, "Segment capacity cannot be negative");
+
+    static constexpr bool PowerOfTwoCapacity = N > 0 && (N & (N - 1)) == 0;
+
+    static constexpr int capacityShift()
+    {
+        int shift = 0;
+        while ((1 << shift) < N)
+        {
+            ++shift;
+        }
+        return shift;
+    }
+
+    // Сегмент - кольцевой буфер: элементы занимают позиции begin, begin + 1, ...
+    // по модулю ёмкости, поэтому операции на обоих концах не сдвигают элементы.
+    // Заголовок и элементы лежат в одном блоке памяти, живые элементы
+    // конструируются и разрушаются явно.
     struct Segment
     {
-        DynamicArray<T> data;
         Segment *next;
         Segment *prev;
+        int begin;
+        int size;
+        int capacity;
+
+        static std::size_t dataOffset()
+        {
+            return (sizeof(Segment) + alignof(T) - 1) / alignof(T) * alignof(T);
+        }
+
+        static std::size_t alignment()
+        {
+            return std::max(alignof(Segment), alignof(T));
+        }
+
+        static std::size_t bytesFor(int capacity)
+        {
+            return dataOffset() + capacity * sizeof(T);
+        }
+
+        static Segment *Create(int capacity, std::pmr::memory_resource *resource)
+        {
+            void *memory = resource->allocate(bytesFor(capacity), alignment());
+            return new (memory) Segment(capacity);
+        }
+
+        static void Destroy(Segment *segment, std::pmr::memory_resource *resource)
+        {
+            int capacity = segment->capacity;
+            segment->Truncate(0);
+            segment->~Segment();
+            resource->deallocate(segment, bytesFor(capacity), alignment());
+        }
+
+        int GetSize() const
+        {
+            return size;
+        }
+
+        int GetCapacity() const
+        {
+            if constexpr (N != DynamicSegmentCapacity)
+            {
+                return N;
+            }
+            else
+            {
+                return capacity;
+            }
+        }
+
+        bool IsFull() const
+        {
+            return size == GetCapacity();
+        }
+
+        int slot(int i) const
+        {
+            int s = begin + i;
+            if constexpr (PowerOfTwoCapacity)
+            {
+                return s & (N - 1);
+            }
+            else
+            {
+                return s >= GetCapacity() ? s - GetCapacity() : s;
+            }
+        }
+
+        T *elements()
+        {
+            return reinterpret_cast<T *>(reinterpret_cast<char *>(this) + dataOffset());
+        }
+
+        const T *elements() const
+        {
+            return reinterpret_cast<const T *>(reinterpret_cast<const char *>(this) + dataOffset());
+        }
+
+        T &At(int i)
+        {
+            return elements()[slot(i)];
+        }
+
+        const T &At(int i) const
+        {
+            return elements()[slot(i)];
+        }
+
+        // Обход живых элементов: не больше двух непрерывных участков блока,
+        // без вычисления позиции для каждого элемента
+        template <typename Action>
+        void ForEachItem(Action &action) const
+        {
+            const T *items = elements();
+            int first = std::min(size, GetCapacity() - begin);
+            for (int i = begin; i < begin + first; ++i)
+            {
+                action(items[i]);
+            }
+            for (int i = 0; i < size - first; ++i)
+            {
+                action(items[i]);
+            }
+        }
+
+        template <typename Action>
+        void ForEachItem(Action &action)
+        {
+            T *items = elements();
+            int first = std::min(size, GetCapacity() - begin);
+            for (int i = begin; i < begin + first; ++i)
+            {
+                action(items[i]);
+            }
+            for (int i = 0; i < size - first; ++i)
+            {
+                action(items[i]);
+            }
+        }
+
+        template <typename... Args>
+        void EmplaceBack(Args &&...args)
+        {
+            new (elements() + slot(size)) T(std::forward<Args>(args)...);
+            ++size;
+        }
+
+        template <typename... Args>
+        void EmplaceFront(Args &&...args)
+        {
+            int first = begin ? begin - 1 : GetCapacity() - 1;
+            new (elements() + first) T(std::forward<Args>(args)...);
+            begin = first;
+            ++size;
+        }
+
+        T PopFront()
+        {
+            T &first = elements()[begin];
+            T result = std::move(first);
+            first.~T();
+            begin = slot(1);
+            --size;
+            return result;
+        }
+
+        T PopBack()
+        {
+            T &last = At(size - 1);
+            T result = std::move(last);
+            last.~T();
+            --size;
+            return result;
+        }
+
+        // Вставка и удаление сдвигают меньшую из двух частей сегмента
+        template <typename U>
+        void Insert(int i, U &&item)
+        {
+            if (i == 0 || i == size)
+            {
+                i == 0 ? EmplaceFront(std::forward<U>(item)) : EmplaceBack(std::forward<U>(item));
+                return;
+            }
+
+            if (i < size / 2)
+            {
+                EmplaceFront(std::move(At(0)));
+                for (int j = 1; j < i; ++j)
+                {
+                    At(j) = std::move(At(j + 1));
+                }
+            }
+            else
+            {
+                EmplaceBack(std::move(At(size - 1)));
+                for (int j = size - 2; j > i; --j)
+                {
+                    At(j) = std::move(At(j - 1));
+                }
+            }
+            At(i) = std::forward<U>(item);
+        }
+
+        T Erase(int i)
+        {
+            T result = std::move(At(i));
+            if (i < size / 2)
+            {
+                for (int j = i; j > 0; --j)
+                {
+                    At(j) = std::move(At(j - 1));
+                }
+                At(0).~T();
+                begin = slot(1);
+            }
+            else
+            {
+                for (int j = i; j < size - 1; ++j)
+                {
+                    At(j) = std::move(At(j + 1));
+                }
+                At(size - 1).~T();
+            }
+            --size;
+            return result;
+        }
+
+        // Копирует элементы source в начало пустого сегмента той же ёмкости;
+        // тривиально копируемые элементы переносятся memcpy двумя кусками
+        void CopyFrom(const Segment &source)
+        {
+            int first = std::min(source.size, source.GetCapacity() - source.begin);
+            const T *front = source.elements() + source.begin;
+            begin = 0;
+            if constexpr (std::is_trivially_copyable<T>::value)
+            {
+                std::memcpy(static_cast<void *>(elements()), front, first * sizeof(T));
+                std::memcpy(static_cast<void *>(elements() + first), source.elements(), (source.size - first) * sizeof(T));
+                size = source.size;
+            }
+            else
+            {
+                // size растёт по мере копирования, чтобы при исключении разрушить готовую часть
+                std::uninitialized_copy(front, front + first, elements());
+                size = first;
+                std::uninitialized_copy(source.elements(), source.elements() + (source.size - first), elements() + first);
+                size = source.size;
+            }
+        }
+
+        void Truncate(int newSize)
+        {
+            for (int i = newSize; i < size; ++i)
+            {
+                At(i).~T();
+            }
+            size = newSize;
+        }
 
-        Segment(int capacity) : data(), next(nullptr), prev(nullptr)
+    private:
+        explicit Segment(int capacity) : next(nullptr), prev(nullptr), begin(0), size(0), capacity(capacity)
         {
-            data.Reserve(capacity);
         }
+
+        ~Segment() = default;
+    };
+
+    // Элемент каталога: сегмент и абсолютная позиция его первого элемента.
+    // Позиции соседних сегментов отличаются ровно на размер сегмента,
+    // поэтому при вставке в начало достаточно сдвинуть позицию головы.
+    struct SegmentRef
+    {
+        Segment *segment;
+        int start;
     };
 
+    static const int DriftLimit = 1 << 30;
+    static const int DefaultSpareLimit = 2;
+
     Segment *head;
     Segment *tail;
     int segmentCapacity;
     int totalSize;
 
-    void ensureCapacity()
+    // Каталог сегментов (как карта в std::deque), свободное место с обеих сторон
+    SegmentRef *directory;
+    int directoryCapacity;
+    int directoryBegin;
+    int directoryEnd;
+
+    // Кэш освобождённых сегментов (односвязный список по next)
+    Segment *spare;
+    int spareCount;
+    int spareLimit;
+
+    // Источник памяти для сегментов и каталога
+    std::pmr::memory_resource *resource;
+
+    int segmentSize() const
     {
-        if (totalSize == 0)
+        if constexpr (N != DynamicSegmentCapacity)
+        {
+            return N;
+        }
+        else
+        {
+            return segmentCapacity;
+        }
+    }
+
+    int divideBySegmentSize(int value) const
+    {
+        if constexpr (PowerOfTwoCapacity)
+        {
+            return value >> capacityShift();
+        }
+        else
+        {
+            return value / segmentSize();
+        }
+    }
+
+    int segmentCount() const
+    {
+        return directoryEnd - directoryBegin;
+    }
+
+    SegmentRef &segmentRef(int k)
+    {
+        return directory[directoryBegin + k];
+    }
+
+    const SegmentRef &segmentRef(int k) const
+    {
+        return directory[directoryBegin + k];
+    }
+
+    SegmentRef *allocateDirectory(int capacity)
+    {
+        return static_cast<SegmentRef *>(resource->allocate(capacity * sizeof(SegmentRef), alignof(SegmentRef)));
+    }
+
+    void deallocateDirectory()
+    {
+        if (directory != nullptr)
+        {
+            resource->deallocate(directory, directoryCapacity * sizeof(SegmentRef), alignof(SegmentRef));
+        }
+    }
+
+    // Переносит каталог в массив новой ёмкости, располагая записи по центру
+    void reallocateDirectory(int newCapacity)
+    {
+        int count = segmentCount();
+        SegmentRef *target = newCapacity == directoryCapacity ? directory : allocateDirectory(newCapacity);
+        int newBegin = (newCapacity - count) / 2;
+
+        if (target != directory || newBegin <= directoryBegin)
+        {
+            std::copy(directory + directoryBegin, directory + directoryEnd, target + newBegin);
+        }
+        else
+        {
+            std::copy_backward(directory + directoryBegin, directory + directoryEnd, target + newBegin + count);
+        }
+
+        if (target != directory)
+        {
+            deallocateDirectory();
+            directory = target;
+            directoryCapacity = newCapacity;
+        }
+        directoryBegin = newBegin;
+        directoryEnd = newBegin + count;
+    }
+
+    void makeDirectoryRoom(bool atFront)
+    {
+        if (atFront ? directoryBegin > 0 : directoryEnd < directoryCapacity)
         {
-            head = tail = new Segment(segmentCapacity);
             return;
         }
 
-        if (tail->data.GetSize() < segmentCapacity)
+        // Если каталог заполнен меньше чем наполовину, достаточно отцентрировать записи
+        if (2 * (segmentCount() + 1) <= directoryCapacity)
+        {
+            reallocateDirectory(directoryCapacity);
+        }
+        else
+        {
+            reallocateDirectory(std::max(8, 2 * directoryCapacity));
+        }
+    }
+
+    // Место в конце каталога под count новых записей
+    void makeDirectoryRoomBack(int count)
+    {
+        if (directoryEnd + count <= directoryCapacity)
         {
             return;
         }
 
-        Segment *newSegment = new Segment(segmentCapacity);
-        tail->next = newSegment;
-        newSegment->prev = tail;
-        tail = newSegment;
+        int needed = segmentCount() + count;
+        reallocateDirectory(2 * needed <= directoryCapacity ? directoryCapacity : std::max(8, 2 * needed));
     }
 
-    void ensureCapacityFront()
+    void linkBack(Segment *segment)
     {
-        if (totalSize == 0)
+        makeDirectoryRoom(false);
+        int start = 0;
+        if (tail)
+        {
+            const SegmentRef &last = segmentRef(segmentCount() - 1);
+            start = last.start + last.segment->GetSize();
+            tail->next = segment;
+            segment->prev = tail;
+        }
+        else
+        {
+            head = segment;
+        }
+        tail = segment;
+        directory[directoryEnd++] = {segment, start};
+    }
+
+    void linkFront(Segment *segment)
+    {
+        makeDirectoryRoom(true);
+        int start = -segment->GetSize();
+        if (head)
+        {
+            start += segmentRef(0).start;
+            head->prev = segment;
+            segment->next = head;
+        }
+        else
+        {
+            tail = segment;
+        }
+        head = segment;
+        directory[--directoryBegin] = {segment, start};
+    }
+
+    // Ставит replacement на место k-го сегмента в списке и каталоге;
+    // позиция в каталоге не меняется, старый сегмент освобождает вызывающий
+    void replaceSegment(int k, Segment *replacement)
+    {
+        Segment *old = segmentRef(k).segment;
+        replacement->prev = old->prev;
+        replacement->next = old->next;
+        if (old->prev)
+        {
+            old->prev->next = replacement;
+        }
+        else
+        {
+            head = replacement;
+        }
+        if (old->next)
+        {
+            old->next->prev = replacement;
+        }
+        else
+        {
+            tail = replacement;
+        }
+        old->prev = old->next = nullptr;
+        segmentRef(k).segment = replacement;
+    }
+
+    // Вставка сегмента в каталог и список сразу после k-го
+    void linkAfter(int k, Segment *segment)
+    {
+        if (k == segmentCount() - 1)
         {
-            head = tail = new Segment(segmentCapacity);
+            linkBack(segment);
             return;
         }
 
-        if (head->data.GetSize() < segmentCapacity)
+        makeDirectoryRoom(false);
+        std::copy_backward(directory + directoryBegin + k + 1, directory + directoryEnd, directory + directoryEnd + 1);
+        ++directoryEnd;
+
+        Segment *before = segmentRef(k).segment;
+        segment->prev = before;
+        segment->next = before->next;
+        before->next->prev = segment;
+        before->next = segment;
+        segmentRef(k + 1) = {segment, segmentRef(k).start + before->GetSize()};
+    }
+
+    // Исключение k-го сегмента из каталога и списка (сам сегмент не удаляется)
+    void unlink(int k)
+    {
+        Segment *segment = segmentRef(k).segment;
+        if (segment->prev)
+        {
+            segment->prev->next = segment->next;
+        }
+        else
+        {
+            head = segment->next;
+        }
+        if (segment->next)
+        {
+            segment->next->prev = segment->prev;
+        }
+        else
+        {
+            tail = segment->prev;
+        }
+        segment->prev = segment->next = nullptr;
+
+        // Сдвигаем меньшую из двух частей каталога
+        if (k < segmentCount() / 2)
+        {
+            std::copy_backward(directory + directoryBegin, directory + directoryBegin + k, directory + directoryBegin + k + 1);
+            ++directoryBegin;
+        }
+        else
+        {
+            std::copy(directory + directoryBegin + k + 1, directory + directoryEnd, directory + directoryBegin + k);
+            --directoryEnd;
+        }
+    }
+
+    void shiftStarts(int from, int delta)
+    {
+        for (int k = from; k < segmentCount(); ++k)
+        {
+            segmentRef(k).start += delta;
+        }
+    }
+
+    // Абсолютные позиции дрейфуют при работе дека как очереди, изредка возвращаем их к нулю
+    void rebaseIfDrifted()
+    {
+        if (segmentCount() == 0)
         {
             return;
         }
+        int origin = segmentRef(0).start;
+        if (origin > DriftLimit || origin < -DriftLimit)
+        {
+            shiftStarts(0, -origin);
+        }
+    }
+
+    Segment *acquireSegment()
+    {
+        if (!spare)
+        {
+            return Segment::Create(segmentSize(), resource);
+        }
 
-        Segment *newSegment = new Segment(segmentCapacity);
-        head->prev = newSegment;
-        newSegment->next = head;
-        head = newSegment;
+        Segment *segment = spare;
+        spare = spare->next;
+        spareCount--;
+        segment->next = nullptr;
+        segment->begin = 0;
+        return segment;
     }
 
-    std::pair<Segment *, int> findSegmentAndIndex(int index) const
+    // Пустой сегмент уходит в кэш, если лимит не исчерпан
+    void releaseSegment(Segment *segment)
+    {
+        if (spareCount >= spareLimit)
+        {
+            Segment::Destroy(segment, resource);
+            return;
+        }
+
+        segment->Truncate(0);
+        segment->prev = nullptr;
+        segment->next = spare;
+        spare = segment;
+        spareCount++;
+    }
+
+    // Возвращает номер сегмента в каталоге и индекс внутри него
+    std::pair<int, int> findSegmentAndIndex(int index) const
     {
         if (index < 0 || index >= totalSize)
         {
             throw std::out_of_range("Index out of range");
         }
 
-        Segment *current = head;
-        int remaining = index;
+        const SegmentRef *refs = directory + directoryBegin;
+        int count = segmentCount();
+        int headSize = refs[0].segment->GetSize();
+        int position = refs[0].start + index;
 
-        while (current != nullptr)
+        // Все сегменты, кроме крайних, заполнены - номер сегмента вычисляется делением
+        int k = index < headSize ? 0 : 1 + divideBySegmentSize(index - headSize);
+        if (k >= count || position < refs[k].start || position - refs[k].start >= refs[k].segment->GetSize())
         {
-            int currentSize = current->data.GetSize();
-            if (remaining < currentSize)
+            // После разделений сегменты неоднородны - бинарный поиск по позициям
+            int lo = 0;
+            int hi = count - 1;
+            while (lo < hi)
             {
-                return {current, remaining};
+                int mid = (lo + hi + 1) / 2;
+                if (refs[mid].start <= position)
+                {
+                    lo = mid;
+                }
+                else
+                {
+                    hi = mid - 1;
+                }
             }
-            remaining -= currentSize;
-            current = current->next;
+            k = lo;
         }
 
-        throw std::out_of_range("Index out of range");
+        return {k, position - refs[k].start};
     }
 
-    // Метод для слияния соседних неполных сегментов
-    void mergeSegments()
+    // Собирает элементы в непрерывный массив, сортирует его и раскладывает
+    // обратно по сегментам, сохраняя их размеры. При workers > 1 сегменты
+    // делятся между потоками: позиция сегмента в массиве берётся из каталога.
+    template <typename Sorter>
+    void sortSegments(Sorter sorter, int workers = 1)
     {
-        Segment *current = head;
-        while (current && current->next)
+        if (totalSize <= 1)
         {
-            if (current->data.GetSize() + current->next->data.GetSize() <= segmentCapacity)
+            return;
+        }
+
+        DynamicArray<T> tempArray;
+        int count = segmentCount();
+        int origin = segmentRef(0).start;
+        workers = std::max(1, std::min(workers, count));
+
+        auto gather = [&](int w)
+        {
+            for (int k = count * w / workers; k < count * (w + 1) / workers; ++k)
             {
-                // Объединяем сегменты
-                for (int i = 0; i < current->next->data.GetSize(); ++i)
+                Segment *segment = segmentRef(k).segment;
+                T *target = &tempArray[segmentRef(k).start - origin];
+                for (int i = 0; i < segment->GetSize(); ++i)
                 {
-                    current->data.Append(current->next->data.Get(i));
+                    target[i] = std::move(segment->At(i));
                 }
+            }
+        };
+        auto scatter = [&](int w)
+        {
+            for (int k = count * w / workers; k < count * (w + 1) / workers; ++k)
+            {
+                Segment *segment = segmentRef(k).segment;
+                T *source = &tempArray[segmentRef(k).start - origin];
+                for (int i = 0; i < segment->GetSize(); ++i)
+                {
+                    segment->At(i) = std::move(source[i]);
+                }
+            }
+        };
 
-                Segment *toDelete = current->next;
-                current->next = toDelete->next;
-                if (toDelete->next)
+        // Без конструктора по умолчанию элементы переносятся в массив последовательно
+        if constexpr (std::is_default_constructible<T>::value)
+        {
+            tempArray.Resize(totalSize);
+            RunInParallel(workers, gather);
+        }
+        else
+        {
+            tempArray.Reserve(totalSize);
+            for (Segment *current = head; current != nullptr; current = current->next)
+            {
+                for (int i = 0; i < current->GetSize(); ++i)
                 {
-                    toDelete->next->prev = current;
+                    tempArray.Append(std::move(current->At(i)));
                 }
-                else
+            }
+        }
+        sorter(tempArray);
+        RunInParallel(workers, scatter);
+    }
+
+    // Дек пуст: повторяет сегменты other с теми же размерами, копируя
+    // каждый сегмент целиком, без проверок ёмкости на каждый элемент
+    void copySegmentsFrom(const SegmentedDeque &other)
+    {
+        int count = other.segmentCount();
+        makeDirectoryRoomBack(count);
+        for (int k = 0; k < count; ++k)
+        {
+            Segment *segment = acquireSegment();
+            try
+            {
+                segment->CopyFrom(*other.segmentRef(k).segment);
+            }
+            catch (...)
+            {
+                releaseSegment(segment);
+                throw;
+            }
+            linkBack(segment);
+            totalSize += segment->GetSize();
+        }
+    }
+
+    // Оставляет дек пустым, не освобождая память: она передана другому объекту
+    void detach()
+    {
+        head = tail = nullptr;
+        totalSize = 0;
+        directory = nullptr;
+        directoryCapacity = directoryBegin = directoryEnd = 0;
+        spare = nullptr;
+        spareCount = 0;
+    }
+
+    // Метод для слияния соседних неполных сегментов
+    void mergeSegments()
+    {
+        int k = 0;
+        while (k + 1 < segmentCount())
+        {
+            Segment *current = segmentRef(k).segment;
+            Segment *following = segmentRef(k + 1).segment;
+            if (current->GetSize() + following->GetSize() <= segmentSize())
+            {
+                // Объединяем сегменты
+                for (int i = 0; i < following->GetSize(); ++i)
                 {
-                    tail = current;
+                    current->EmplaceBack(std::move(following->At(i)));
                 }
-                delete toDelete;
+
+                unlink(k + 1);
+                releaseSegment(following);
             }
             else
             {
-                current = current->next;
+                ++k;
             }
         }
     }
 
-public:
-    SegmentedDeque(int segmentSize = 4) : head(nullptr), tail(nullptr), segmentCapacity(segmentSize), totalSize(0)
+    // Обход всех элементов по сегментам, без поиска позиций через каталог
+    template <typename Action>
+    void forEachItem(Action &&action) const
     {
-        if (segmentSize <= 0)
+        for (Segment *current = head; current != nullptr; current = current->next)
         {
-            throw std::invalid_argument("Segment size must be positive");
+            current->ForEachItem(action);
         }
     }
 
-    SegmentedDeque(const SegmentedDeque<T> &other) : head(nullptr), tail(nullptr), segmentCapacity(other.segmentCapacity), totalSize(0)
+public:
+    // Итератор произвольного доступа: сегмент, позиция в нём и индекс в деке.
+    // Шаг внутри сегмента не трогает каталог, переход по списку сегментов - O(1),
+    // прыжок за пределы текущего сегмента ищет сегмент через каталог.
+    // Любое изменение дека делает итераторы недействительными.
+    template <bool IsConst>
+    class BasicIterator
     {
-        Segment *current = other.head;
-        while (current != nullptr)
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T *, T *>;
+        using reference = std::conditional_t<IsConst, const T &, T &>;
+
+        BasicIterator() = default;
+
+        template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+        BasicIterator(const BasicIterator<OtherConst> &other)
+            : deque(other.deque), segment(other.segment), offset(other.offset), position(other.position)
+        {
+        }
+
+        reference operator*() const
+        {
+            return segment->At(offset);
+        }
+
+        pointer operator->() const
+        {
+            return &segment->At(offset);
+        }
+
+        reference operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+
+        BasicIterator &operator++()
         {
-            for (int i = 0; i < current->data.GetSize(); ++i)
+            ++position;
+            if (++offset == segment->GetSize())
             {
-                AppendInPlace(current->data.Get(i));
+                segment = segment->next;
+                offset = 0;
             }
-            current = current->next;
+            return *this;
+        }
+
+        BasicIterator &operator--()
+        {
+            --position;
+            if (offset == 0)
+            {
+                segment = segment ? segment->prev : deque->tail;
+                offset = segment->GetSize();
+            }
+            --offset;
+            return *this;
+        }
+
+        BasicIterator operator++(int)
+        {
+            BasicIterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        BasicIterator operator--(int)
+        {
+            BasicIterator old = *this;
+            --*this;
+            return old;
+        }
+
+        BasicIterator &operator+=(difference_type n)
+        {
+            if (segment && offset + n >= 0 && offset + n < segment->GetSize())
+            {
+                offset += n;
+                position += n;
+            }
+            else
+            {
+                seek(position + n);
+            }
+            return *this;
         }
+
+        BasicIterator &operator-=(difference_type n)
+        {
+            return *this += -n;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type n)
+        {
+            return it += n;
+        }
+
+        friend BasicIterator operator+(difference_type n, BasicIterator it)
+        {
+            return it += n;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type n)
+        {
+            return it -= n;
+        }
+
+        difference_type operator-(const BasicIterator &other) const
+        {
+            return position - other.position;
+        }
+
+        bool operator==(const BasicIterator &other) const { return position == other.position; }
+        bool operator!=(const BasicIterator &other) const { return position != other.position; }
+        bool operator<(const BasicIterator &other) const { return position < other.position; }
+        bool operator>(const BasicIterator &other) const { return position > other.position; }
+        bool operator<=(const BasicIterator &other) const { return position <= other.position; }
+        bool operator>=(const BasicIterator &other) const { return position >= other.position; }
+
+    private:
+        friend class SegmentedDeque;
+        template <bool> friend class BasicIterator;
+
+        const SegmentedDeque *deque = nullptr;
+        Segment *segment = nullptr;
+        int offset = 0;
+        int position = 0;
+
+        BasicIterator(const SegmentedDeque *deque, int index) : deque(deque)
+        {
+            seek(index);
+        }
+
+        void seek(int index)
+        {
+            position = index;
+            if (index == deque->totalSize)
+            {
+                segment = nullptr;
+                offset = 0;
+                return;
+            }
+            auto [k, idx] = deque->findSegmentAndIndex(index);
+            segment = deque->segmentRef(k).segment;
+            offset = idx;
+        }
+    };
+
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    Iterator begin()
+    {
+        return Iterator(this, 0);
+    }
+
+    Iterator end()
+    {
+        return Iterator(this, totalSize);
+    }
+
+    ConstIterator begin() const
+    {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const
+    {
+        return ConstIterator(this, totalSize);
+    }
+
+    SegmentedDeque(int segmentSize = N ? N : DefaultSegmentCapacity<T>(),
+                   std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : head(nullptr), tail(nullptr), segmentCapacity(segmentSize), totalSize(0),
+          directory(nullptr), directoryCapacity(0), directoryBegin(0), directoryEnd(0),
+          spare(nullptr), spareCount(0), spareLimit(DefaultSpareLimit), resource(resource)
+    {
+        if (segmentSize <= 0)
+        {
+            throw std::invalid_argument("Segment size must be positive");
+        }
+        if (N != DynamicSegmentCapacity && segmentSize != N)
+        {
+            throw std::invalid_argument("Segment size is fixed by the template parameter");
+        }
+    }
+
+    explicit SegmentedDeque(std::pmr::memory_resource *resource) : SegmentedDeque(N ? N : DefaultSegmentCapacity<T>(), resource)
+    {
+    }
+
+    // Копия размещается в том же ресурсе, что и оригинал
+    SegmentedDeque(const SegmentedDeque &other) : SegmentedDeque(other, other.resource)
+    {
+    }
+
+    // Копия сохраняет разбиение на сегменты; делегирование гарантирует вызов
+    // деструктора, если копирование элемента бросит исключение
+    SegmentedDeque(const SegmentedDeque &other, std::pmr::memory_resource *resource)
+        : SegmentedDeque(other.segmentCapacity, resource)
+    {
+        spareLimit = other.spareLimit;
+        copySegmentsFrom(other);
+    }
+
+    SegmentedDeque(SegmentedDeque &&other) noexcept
+        : head(other.head), tail(other.tail), segmentCapacity(other.segmentCapacity), totalSize(other.totalSize),
+          directory(other.directory), directoryCapacity(other.directoryCapacity),
+          directoryBegin(other.directoryBegin), directoryEnd(other.directoryEnd),
+          spare(other.spare), spareCount(other.spareCount), spareLimit(other.spareLimit), resource(other.resource)
+    {
+        other.detach();
     }
 
     // Оператор присваивания
-    SegmentedDeque<T> &operator=(const SegmentedDeque<T> &other)
+    SegmentedDeque &operator=(const SegmentedDeque &other)
     {
         if (this == &other)
             return *this;
 
         Clear();
-        segmentCapacity = other.segmentCapacity;
-
-        Segment *current = other.head;
-        while (current != nullptr)
+        if (segmentCapacity != other.segmentCapacity)
         {
-            for (int i = 0; i < current->data.GetSize(); ++i)
-            {
-                AppendInPlace(current->data.Get(i));
-            }
-            current = current->next;
+            ReleaseSpares();
         }
+        segmentCapacity = other.segmentCapacity;
+        copySegmentsFrom(other);
+        return *this;
+    }
+
+    // Перемещающее присваивание забирает сегменты, каталог, кэш и ресурс другого дека
+    SegmentedDeque &operator=(SegmentedDeque &&other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        Clear();
+        ReleaseSpares();
+        deallocateDirectory();
+
+        head = other.head;
+        tail = other.tail;
+        segmentCapacity = other.segmentCapacity;
+        totalSize = other.totalSize;
+        directory = other.directory;
+        directoryCapacity = other.directoryCapacity;
+        directoryBegin = other.directoryBegin;
+        directoryEnd = other.directoryEnd;
+        spare = other.spare;
+        spareCount = other.spareCount;
+        spareLimit = other.spareLimit;
+        resource = other.resource;
+        other.detach();
         return *this;
     }
 
     ~SegmentedDeque()
     {
         Clear();
+        ReleaseSpares();
+        deallocateDirectory();
     }
 
     T GetFirst() const override
@@ -174,7 +1060,7 @@ public:
         {
             throw std::out_of_range("Deque is empty");
         }
-        return head->data.Get(0);
+        return head->At(0);
     }
 
     T GetLast() const override
@@ -183,13 +1069,13 @@ public:
         {
             throw std::out_of_range("Deque is empty");
         }
-        return tail->data.Get(tail->data.GetSize() - 1);
+        return tail->At(tail->GetSize() - 1);
     }
 
     T Get(int index) const override
     {
-        auto [segment, idx] = findSegmentAndIndex(index);
-        return segment->data.Get(idx);
+        auto [k, idx] = findSegmentAndIndex(index);
+        return segmentRef(k).segment->At(idx);
     }
 
     Sequence<T> *GetSubsequence(int startIndex, int endIndex) const override
@@ -199,74 +1085,123 @@ public:
             throw std::out_of_range("Invalid indices");
         }
 
-        SegmentedDeque<T> *subseq = new SegmentedDeque<T>(segmentCapacity);
-        for (int i = startIndex; i <= endIndex; ++i)
+        SegmentedDeque *subseq = new SegmentedDeque(segmentSize(), resource);
+        for (auto it = begin() + startIndex, last = begin() + endIndex + 1; it != last; ++it)
         {
-            subseq->AppendInPlace(Get(i));
+            subseq->AppendInPlace(*it);
         }
         return subseq;
     }
 
+    // Срез без копирования, см. SequenceView
+    SequenceView<T, SegmentedDeque> GetSlice(int startIndex, int endIndex) const
+    {
+        return SequenceView<T, SegmentedDeque>(*this, startIndex, endIndex);
+    }
+
     int GetLength() const override
     {
         return totalSize;
     }
 
+    int GetSegmentCapacity() const
+    {
+        return segmentSize();
+    }
+
     // Проверка на пустоту
     bool IsEmpty() const
     {
         return totalSize == 0;
     }
 
-    void AppendInPlace(T item) override
+    void AppendInPlace(const T &item) override
     {
-        ensureCapacity();
-        tail->data.Append(item);
-        totalSize++;
+        EmplaceBack(item);
     }
 
-    // Улучшенная версия PrependInPlace
-    void PrependInPlace(T item) override
+    void AppendInPlace(T &&item) override
     {
-        if (totalSize == 0)
+        EmplaceBack(std::move(item));
+    }
+
+    void PrependInPlace(const T &item) override
+    {
+        EmplaceFront(item);
+    }
+
+    void PrependInPlace(T &&item) override
+    {
+        EmplaceFront(std::move(item));
+    }
+
+    void InsertAtInPlace(const T &item, int index) override
+    {
+        EmplaceAt(index, item);
+    }
+
+    void InsertAtInPlace(T &&item, int index) override
+    {
+        EmplaceAt(index, std::move(item));
+    }
+
+    // Конструирует элемент прямо в памяти сегмента. Новый сегмент попадает
+    // в дек только с готовым элементом: если конструктор бросит исключение,
+    // сегмент освобождается, а дек остаётся прежним
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args)
+    {
+        if (tail && !tail->IsFull())
         {
-            ensureCapacity();
-            head->data.Append(item);
-            totalSize++;
-            return;
+            tail->EmplaceBack(std::forward<Args>(args)...);
         }
-
-        // Если в первом сегменте есть место, просто вставляем в начало
-        if (head->data.GetSize() < segmentCapacity)
+        else
         {
-            // Более эффективная вставка в начало
-            head->data.Resize(head->data.GetSize() + 1);
-            for (int i = head->data.GetSize() - 1; i > 0; --i)
+            Segment *segment = acquireSegment();
+            try
+            {
+                segment->EmplaceBack(std::forward<Args>(args)...);
+                linkBack(segment);
+            }
+            catch (...)
             {
-                head->data.Set(i, head->data.Get(i - 1));
+                releaseSegment(segment);
+                throw;
             }
-            head->data.Set(0, item);
+        }
+        totalSize++;
+        return tail->At(tail->GetSize() - 1);
+    }
+
+    template <typename... Args>
+    T &EmplaceFront(Args &&...args)
+    {
+        if (head && !head->IsFull())
+        {
+            head->EmplaceFront(std::forward<Args>(args)...);
+            segmentRef(0).start--;
         }
         else
         {
-            // Создаем новый сегмент в начале
-            Segment *newSegment = new Segment(segmentCapacity);
-            newSegment->data.Append(item);
-            newSegment->next = head;
-            if (head)
+            Segment *segment = acquireSegment();
+            try
             {
-                head->prev = newSegment;
+                segment->EmplaceFront(std::forward<Args>(args)...);
+                linkFront(segment);
             }
-            head = newSegment;
-            if (!tail)
+            catch (...)
             {
-                tail = head;
+                releaseSegment(segment);
+                throw;
             }
         }
         totalSize++;
+        rebaseIfDrifted();
+        return head->At(0);
     }
 
-    void InsertAtInPlace(T item, int index) override
+    template <typename... Args>
+    void EmplaceAt(int index, Args &&...args)
     {
         if (index < 0 || index > totalSize)
         {
@@ -275,77 +1210,80 @@ public:
 
         if (index == 0)
         {
-            PrependInPlace(item);
+            EmplaceFront(std::forward<Args>(args)...);
             return;
         }
         if (index == totalSize)
         {
-            AppendInPlace(item);
+            EmplaceBack(std::forward<Args>(args)...);
             return;
         }
 
-        auto [segment, idx] = findSegmentAndIndex(index);
+        T item(std::forward<Args>(args)...);
+        auto [k, idx] = findSegmentAndIndex(index);
+        Segment *segment = segmentRef(k).segment;
 
-        if (segment->data.GetSize() < segmentCapacity)
-        {
-            // Есть место в сегменте - просто сдвигаем элементы
-            segment->data.Resize(segment->data.GetSize() + 1);
-            for (int i = segment->data.GetSize() - 1; i > idx; --i)
-            {
-                segment->data.Set(i, segment->data.Get(i - 1));
-            }
-            segment->data.Set(idx, item);
-        }
-        else
+        if (!segment->IsFull())
         {
-            // Сегмент полон - разделяем его
-            Segment *newSegment = new Segment(segmentCapacity);
-            newSegment->next = segment->next;
-            if (segment->next)
+            // Есть место в сегменте - сдвигаем меньшую часть
+            int oldSize = segment->GetSize();
+            try
             {
-                segment->next->prev = newSegment;
+                segment->Insert(idx, std::move(item));
             }
-            else
-            {
-                tail = newSegment;
-            }
-            segment->next = newSegment;
-            newSegment->prev = segment;
-
-            // Определяем середину для разделения
-            int mid = segmentCapacity / 2;
-            
-            if (idx <= mid)
+            catch (...)
             {
-                // Вставляем в первую половину
-                for (int i = mid; i < segmentCapacity; ++i)
+                // Сдвиг прерван: сегмент уже вырос на позицию, учитываем её,
+                // чтобы размеры и каталог остались согласованными
+                if (segment->GetSize() != oldSize)
                 {
-                    newSegment->data.Append(segment->data.Get(i));
+                    shiftStarts(k + 1, 1);
+                    totalSize++;
                 }
-                segment->data.Resize(mid);
-                
-                // Вставляем элемент
-                segment->data.Resize(segment->data.GetSize() + 1);
-                for (int i = segment->data.GetSize() - 1; i > idx; --i)
-                {
-                    segment->data.Set(i, segment->data.Get(i - 1));
-                }
-                segment->data.Set(idx, item);
+                throw;
             }
-            else
+            shiftStarts(k + 1, 1);
+        }
+        else
+        {
+            // Сегмент полон - делим его на два новых сегмента вместе с новым
+            // элементом. Исходный сегмент подменяется только после того, как
+            // половины собраны, поэтому исключение при копировании его не трогает
+            makeDirectoryRoom(false);
+            int mid = segmentSize() / 2;
+            int leftCount = idx <= mid ? mid + 1 : mid;
+            Segment *left = acquireSegment();
+            Segment *right = nullptr;
+            try
             {
-                // Вставляем во вторую половину
-                for (int i = mid; i < idx; ++i)
+                right = acquireSegment();
+                for (int i = 0; i <= segment->GetSize(); ++i)
                 {
-                    newSegment->data.Append(segment->data.Get(i));
+                    Segment *target = i < leftCount ? left : right;
+                    if (i == idx)
+                    {
+                        target->EmplaceBack(std::move_if_noexcept(item));
+                    }
+                    else
+                    {
+                        target->EmplaceBack(std::move_if_noexcept(segment->At(i < idx ? i : i - 1)));
+                    }
                 }
-                newSegment->data.Append(item);
-                for (int i = idx; i < segmentCapacity; ++i)
+            }
+            catch (...)
+            {
+                releaseSegment(left);
+                if (right)
                 {
-                    newSegment->data.Append(segment->data.Get(i));
+                    releaseSegment(right);
                 }
-                segment->data.Resize(mid);
+                throw;
             }
+
+            replaceSegment(k, left);
+            releaseSegment(segment);
+            linkAfter(k, right);
+            shiftStarts(k + 2, 1);
         }
         totalSize++;
     }
@@ -358,30 +1296,18 @@ public:
             throw std::out_of_range("Deque is empty");
         }
 
-        T result = head->data.Get(0);
-
-        // Сдвигаем элементы в первом сегменте
-        for (int i = 0; i < head->data.GetSize() - 1; ++i)
-        {
-            head->data.Set(i, head->data.Get(i + 1));
-        }
-        head->data.Resize(head->data.GetSize() - 1);
+        T result = head->PopFront();
+        segmentRef(0).start++;
         totalSize--;
 
-        // Если сегмент стал пустым и есть следующий
-        if (head->data.GetSize() == 0 && head->next)
+        // Если сегмент стал пустым, удаляем его
+        if (head->GetSize() == 0)
         {
             Segment *oldHead = head;
-            head = head->next;
-            head->prev = nullptr;
-            delete oldHead;
-        }
-
-        // Если дек стал пустым
-        if (totalSize == 0)
-        {
-            head = tail = nullptr;
+            unlink(0);
+            releaseSegment(oldHead);
         }
+        rebaseIfDrifted();
 
         return result;
     }
@@ -394,23 +1320,15 @@ public:
             throw std::out_of_range("Deque is empty");
         }
 
-        T result = tail->data.Get(tail->data.GetSize() - 1);
-        tail->data.Resize(tail->data.GetSize() - 1);
+        T result = tail->PopBack();
         totalSize--;
 
-        // Если сегмент стал пустым и есть предыдущий
-        if (tail->data.GetSize() == 0 && tail->prev)
+        // Если сегмент стал пустым, удаляем его
+        if (tail->GetSize() == 0)
         {
             Segment *oldTail = tail;
-            tail = tail->prev;
-            tail->next = nullptr;
-            delete oldTail;
-        }
-
-        // Если дек стал пустым
-        if (totalSize == 0)
-        {
-            head = tail = nullptr;
+            unlink(segmentCount() - 1);
+            releaseSegment(oldTail);
         }
 
         return result;
@@ -429,39 +1347,17 @@ public:
         if (index == totalSize - 1)
             return PopBack();
 
-        auto [segment, idx] = findSegmentAndIndex(index);
-        T result = segment->data.Get(idx);
-
-        // Сдвигаем элементы в сегменте
-        for (int i = idx; i < segment->data.GetSize() - 1; ++i)
-        {
-            segment->data.Set(i, segment->data.Get(i + 1));
-        }
-        segment->data.Resize(segment->data.GetSize() - 1);
+        auto [k, idx] = findSegmentAndIndex(index);
+        Segment *segment = segmentRef(k).segment;
+        T result = segment->Erase(idx);
+        shiftStarts(k + 1, -1);
         totalSize--;
 
         // Если сегмент стал пустым, удаляем его
-        if (segment->data.GetSize() == 0)
+        if (segment->GetSize() == 0)
         {
-            if (segment->prev)
-            {
-                segment->prev->next = segment->next;
-            }
-            else
-            {
-                head = segment->next;
-            }
-
-            if (segment->next)
-            {
-                segment->next->prev = segment->prev;
-            }
-            else
-            {
-                tail = segment->prev;
-            }
-
-            delete segment;
+            unlink(k);
+            releaseSegment(segment);
         }
 
         return result;
@@ -469,128 +1365,356 @@ public:
 
     Sequence<T> *Append(T item) const override
     {
-        SegmentedDeque<T> *newDeque = new SegmentedDeque<T>(*this);
+        SegmentedDeque *newDeque = new SegmentedDeque(*this);
         newDeque->AppendInPlace(item);
         return newDeque;
     }
 
     Sequence<T> *Prepend(T item) const override
     {
-        SegmentedDeque<T> *newDeque = new SegmentedDeque<T>(*this);
+        SegmentedDeque *newDeque = new SegmentedDeque(*this);
         newDeque->PrependInPlace(item);
         return newDeque;
     }
 
     Sequence<T> *InsertAt(T item, int index) const override
     {
-        SegmentedDeque<T> *newDeque = new SegmentedDeque<T>(*this);
+        SegmentedDeque *newDeque = new SegmentedDeque(*this);
         newDeque->InsertAtInPlace(item, index);
         return newDeque;
     }
 
     Sequence<T> *Concat(Sequence<T> *other) const override
     {
-        SegmentedDeque<T> *newDeque = new SegmentedDeque<T>(*this);
-        for (int i = 0; i < other->GetLength(); ++i)
+        SegmentedDeque *newDeque = new SegmentedDeque(*this);
+        if (auto *deque = dynamic_cast<const SegmentedDeque *>(other))
         {
-            newDeque->AppendInPlace(other->Get(i));
+            // Дек того же типа копируется целыми сегментами и подвешивается в конец
+            SegmentedDeque copy(*deque, resource);
+            newDeque->SpliceBack(copy);
+            return newDeque;
         }
+        other->ForEach([newDeque](const T &item)
+                       { newDeque->AppendInPlace(item); });
         return newDeque;
     }
 
-    void SortInPlace(const std::function<bool(const T &, const T &)> &comparator = [](const T &a, const T &b)
-                     { return a < b; })
+    // Переносит сегменты other в конец дека без копирования элементов,
+    // other становится пустым. Переписываются только записи каталога.
+    // Если сегменты other другой ёмкости или из несовместимого ресурса,
+    // элементы переносятся по одному.
+    void SpliceBack(SegmentedDeque &other)
     {
-        // Более эффективная сортировка без полного копирования
-        if (totalSize <= 1) return;
-        
-        // Собираем все элементы
-        DynamicArray<T> tempArray;
-        Segment *current = head;
-        while (current != nullptr)
+        if (this == &other)
+        {
+            throw std::invalid_argument("Cannot splice a deque into itself");
+        }
+        if (other.totalSize == 0)
+        {
+            return;
+        }
+
+        if (segmentSize() != other.segmentSize() || !resource->is_equal(*other.resource))
         {
-            for (int i = 0; i < current->data.GetSize(); ++i)
+            for (T &item : other)
             {
-                tempArray.Append(current->data.Get(i));
-                
+                EmplaceBack(std::move(item));
             }
-            current = current->next;
+            other.Clear();
+            return;
         }
 
-        // Сортируем
-        tempArray.SortInPlace(comparator);
+        int count = other.segmentCount();
+        makeDirectoryRoomBack(count);
 
-        // Распределяем обратно по сегментам
-        int tempIndex = 0;
-        current = head;
-        while (current != nullptr && tempIndex < tempArray.GetSize())
+        int start = 0;
+        if (tail)
         {
-            int segmentSize = current->data.GetSize();
-            current->data.Resize(0); // Очищаем сегмент
-            
-            for (int i = 0; i < segmentSize && tempIndex < tempArray.GetSize(); ++i)
-            {
-                current->data.Append(tempArray.Get(tempIndex++));
-            }
-            current = current->next;
+            const SegmentRef &last = segmentRef(segmentCount() - 1);
+            start = last.start + last.segment->GetSize();
+            tail->next = other.head;
+            other.head->prev = tail;
+        }
+        else
+        {
+            head = other.head;
+        }
+        tail = other.tail;
+
+        int origin = other.segmentRef(0).start;
+        for (int k = 0; k < count; ++k)
+        {
+            const SegmentRef &ref = other.segmentRef(k);
+            directory[directoryEnd++] = {ref.segment, start + (ref.start - origin)};
+        }
+        totalSize += other.totalSize;
+        rebaseIfDrifted();
+
+        other.head = other.tail = nullptr;
+        other.totalSize = 0;
+        other.directoryBegin = other.directoryEnd = other.directoryCapacity / 2;
+    }
+
+    void AppendMoved(SegmentedDeque &&other)
+    {
+        SpliceBack(other);
+    }
+
+    // Версия с std::function нужна для вызова через Sequence<T>*,
+    // при вызове на самом деке лямбда уходит в шаблонную перегрузку
+    void ForEach(const std::function<void(const T &)> &action) const override
+    {
+        forEachItem(action);
+    }
+
+    template <typename Action>
+    void ForEach(Action action) const
+    {
+        forEachItem(action);
+    }
+
+    template <typename Compare = std::less<T>>
+    void SortInPlace(Compare comparator = Compare())
+    {
+        sortSegments([&](DynamicArray<T> &items)
+                     { items.SortInPlace(comparator); });
+    }
+
+    // Параллельная сортировка; threads = 0 - по числу аппаратных потоков
+    template <typename Compare = std::less<T>>
+    void SortInPlaceParallel(Compare comparator = Compare(), int threads = 0)
+    {
+        if (totalSize < ParallelSortThreshold)
+        {
+            SortInPlace(comparator);
+            return;
         }
+
+        threads = ResolveThreadCount(threads);
+        sortSegments([&](DynamicArray<T> &items)
+                     { items.SortInPlaceParallel(comparator, threads); },
+                     threads);
     }
 
-    Sequence<T> *Sort(const std::function<bool(const T &, const T &)> &comparator = [](const T &a, const T &b)
-                      { return a < b; }) const
+    // Сортировка, сохраняющая порядок равных элементов
+    template <typename Compare = std::less<T>>
+    void StableSortInPlace(Compare comparator = Compare())
     {
-        SegmentedDeque<T> *newDeque = new SegmentedDeque<T>(*this);
+        sortSegments([&](DynamicArray<T> &items)
+                     { items.StableSortInPlace(comparator); });
+    }
+
+    template <typename Compare = std::less<T>>
+    Sequence<T> *Sort(Compare comparator = Compare()) const
+    {
+        SegmentedDeque *newDeque = new SegmentedDeque(*this);
         newDeque->SortInPlace(comparator);
         return newDeque;
     }
 
-    Sequence<T> *Map(const std::function<T(const T &)> &mapper) const
+    template <typename Mapper>
+    Sequence<T> *Map(Mapper mapper) const
     {
-        SegmentedDeque<T> *newDeque = new SegmentedDeque<T>(segmentCapacity);
-        Segment *current = head;
-        while (current != nullptr)
+        SegmentedDeque *newDeque = new SegmentedDeque(segmentSize(), resource);
+        try
         {
-            for (int i = 0; i < current->data.GetSize(); ++i)
-            {
-                newDeque->AppendInPlace(mapper(current->data.Get(i)));
-            }
-            current = current->next;
+            forEachItem([newDeque, &mapper](const T &item)
+                        { newDeque->AppendInPlace(mapper(item)); });
+        }
+        catch (...)
+        {
+            delete newDeque;
+            throw;
         }
         return newDeque;
     }
 
-    Sequence<T> *Where(const std::function<bool(const T &)> &predicate) const
+    template <typename Predicate>
+    Sequence<T> *Where(Predicate predicate) const
     {
-        SegmentedDeque<T> *newDeque = new SegmentedDeque<T>(segmentCapacity);
-        Segment *current = head;
-        while (current != nullptr)
+        SegmentedDeque *newDeque = new SegmentedDeque(segmentSize(), resource);
+        try
+        {
+            forEachItem([newDeque, &predicate](const T &item)
+                        {
+                            if (predicate(item))
+                            {
+                                newDeque->AppendInPlace(item);
+                            }
+                        });
+        }
+        catch (...)
+        {
+            delete newDeque;
+            throw;
+        }
+        return newDeque;
+    }
+
+    // Для простых лямбд сводится к циклу по непрерывным участкам сегментов
+    template <typename Reducer>
+    T Reduce(Reducer reducer, T initial) const
+    {
+        T result = std::move(initial);
+        forEachItem([&result, &reducer](const T &item)
+                    { result = reducer(result, item); });
+        return result;
+    }
+
+    // Замена каждого элемента на transform(элемент) без нового дека
+    template <typename Transform>
+    void TransformInPlace(Transform transform)
+    {
+        auto apply = [&transform](T &item)
+        { item = transform(std::as_const(item)); };
+        for (Segment *current = head; current != nullptr; current = current->next)
         {
-            for (int i = 0; i < current->data.GetSize(); ++i)
+            current->ForEachItem(apply);
+        }
+    }
+
+    // Оставляет элементы, для которых predicate истинен, с сохранением порядка.
+    // Выжившие за один проход сдвигаются к началу дека через границы сегментов;
+    // размеры и позиции сегментов до последнего заполненного не меняются,
+    // поэтому каталог только укорачивается, а освободившиеся сегменты
+    // возвращаются в кэш или ресурс. Возвращает число удалённых элементов
+    template <typename Predicate>
+    int RetainIf(Predicate predicate)
+    {
+        Segment *write = head;
+        int writeIndex = 0;
+        int kept = 0;
+        for (Segment *read = head; read != nullptr; read = read->next)
+        {
+            for (int i = 0; i < read->GetSize(); ++i)
             {
-                T item = current->data.Get(i);
-                if (predicate(item))
+                T &item = read->At(i);
+                if (!predicate(std::as_const(item)))
+                {
+                    continue;
+                }
+                if (writeIndex == write->GetSize())
+                {
+                    write = write->next;
+                    writeIndex = 0;
+                }
+                if (write != read || writeIndex != i)
                 {
-                    newDeque->AppendInPlace(item);
+                    write->At(writeIndex) = std::move(item);
                 }
+                ++writeIndex;
+                ++kept;
             }
-            current = current->next;
         }
-        return newDeque;
+
+        int removed = totalSize - kept;
+        if (kept == 0)
+        {
+            Clear();
+            return removed;
+        }
+
+        write->Truncate(writeIndex);
+        while (tail != write)
+        {
+            Segment *oldTail = tail;
+            unlink(segmentCount() - 1);
+            releaseSegment(oldTail);
+        }
+        totalSize = kept;
+        return removed;
     }
 
-    T Reduce(const std::function<T(const T &, const T &)> &reducer, T initial) const
+    template <typename Predicate>
+    int EraseIf(Predicate predicate)
     {
-        T result = initial;
-        Segment *current = head;
-        while (current != nullptr)
+        return RetainIf([&predicate](const T &item)
+                        { return !predicate(item); });
+    }
+
+    // Ленивый конвейер: Where и Map только запоминают функции, а Reduce,
+    // ForEach и Materialize один раз проходят по сегментам и проводят каждый
+    // элемент через все стадии, не создавая промежуточных деков.
+    // Дек не должен меняться, пока конвейер используется
+    template <typename Value, typename Feed>
+    class LazyPipeline
+    {
+    public:
+        LazyPipeline(const SegmentedDeque *deque, Feed feed) : deque(deque), feed(std::move(feed))
+        {
+        }
+
+        template <typename Predicate>
+        auto Where(Predicate predicate) const
+        {
+            auto stage = [feed = feed, predicate](auto &&sink)
+            {
+                feed([&](const Value &item)
+                     {
+                         if (predicate(item))
+                         {
+                             sink(item);
+                         }
+                     });
+            };
+            return LazyPipeline<Value, decltype(stage)>(deque, std::move(stage));
+        }
+
+        template <typename Mapper>
+        auto Map(Mapper mapper) const
+        {
+            using Result = std::decay_t<std::invoke_result_t<const Mapper &, const Value &>>;
+            auto stage = [feed = feed, mapper](auto &&sink)
+            {
+                feed([&](const Value &item)
+                     { sink(mapper(item)); });
+            };
+            return LazyPipeline<Result, decltype(stage)>(deque, std::move(stage));
+        }
+
+        template <typename Reducer, typename Result>
+        Result Reduce(Reducer reducer, Result initial) const
+        {
+            Result result = std::move(initial);
+            feed([&](const Value &item)
+                 { result = reducer(std::move(result), item); });
+            return result;
+        }
+
+        template <typename Action>
+        void ForEach(Action action) const
+        {
+            feed([&](const Value &item)
+                 { action(item); });
+        }
+
+        // Результат - новый дек с той же ёмкостью сегмента и тем же ресурсом
+        SegmentedDeque<Value, N> *Materialize() const
         {
-            for (int i = 0; i < current->data.GetSize(); ++i)
+            auto *result = new SegmentedDeque<Value, N>(deque->segmentSize(), deque->resource);
+            try
             {
-                result = reducer(result, current->data.Get(i));
+                feed([result](const Value &item)
+                     { result->AppendInPlace(item); });
             }
-            current = current->next;
+            catch (...)
+            {
+                delete result;
+                throw;
+            }
+            return result;
         }
-        return result;
+
+    private:
+        const SegmentedDeque *deque;
+        Feed feed;
+    };
+
+    auto Lazy() const
+    {
+        auto source = [this](auto &&sink)
+        { forEachItem(sink); };
+        return LazyPipeline<T, decltype(source)>(this, std::move(source));
     }
 
     bool ContainsSubsequence(const Sequence<T> &subseq) const
@@ -604,23 +1728,12 @@ public:
             return false;
         }
 
-        for (int i = 0; i <= totalSize - subseq.GetLength(); ++i)
-        {
-            bool match = true;
-            for (int j = 0; j < subseq.GetLength(); ++j)
-            {
-                if (Get(i + j) != subseq.Get(j))
-                {
-                    match = false;
-                    break;
-                }
-            }
-            if (match)
-            {
-                return true;
-            }
-        }
-        return false;
+        // Образец копируется один раз, дальше сравнение идёт по итераторам
+        DynamicArray<T> pattern;
+        pattern.Reserve(subseq.GetLength());
+        subseq.ForEach([&pattern](const T &item)
+                       { pattern.Append(item); });
+        return std::search(begin(), end(), pattern.begin(), pattern.end()) != end();
     }
 
     void Clear()
@@ -629,11 +1742,12 @@ public:
         while (current != nullptr)
         {
             Segment *next = current->next;
-            delete current;
+            releaseSegment(current);
             current = next;
         }
         head = tail = nullptr;
         totalSize = 0;
+        directoryBegin = directoryEnd = directoryCapacity / 2;
     }
 
     void Optimize()
@@ -641,45 +1755,80 @@ public:
         mergeSegments();
     }
 
+    // Заранее выделяет сегменты под expectedSize элементов; они хранятся в кэше
+    // сверх лимита, пока не будут использованы
     void Reserve(int expectedSize)
     {
-        int segmentsNeeded = (expectedSize + segmentCapacity - 1) / segmentCapacity;
-        int currentSegments = 0;
-        
-        Segment *current = head;
-        while (current)
+        int segmentsNeeded = (expectedSize + segmentSize() - 1) / segmentSize();
+        if (2 * segmentsNeeded > directoryCapacity)
         {
-            currentSegments++;
-            current = current->next;
+            reallocateDirectory(2 * segmentsNeeded);
         }
-        
-        for (int i = currentSegments; i < segmentsNeeded; ++i)
+
+        int available = totalSize + (tail ? segmentSize() - tail->GetSize() : 0) + spareCount * segmentSize();
+        for (; available < expectedSize; available += segmentSize())
         {
-            ensureCapacity();
+            Segment *segment = Segment::Create(segmentSize(), resource);
+            segment->next = spare;
+            spare = segment;
+            spareCount++;
         }
     }
 
-    void PrintDebugInfo() const
+    // Максимальное число пустых сегментов, сохраняемых для повторного использования
+    void SetSpareLimit(int limit)
     {
-        std::cout << "SegmentedDeque (size=" << totalSize << ", capacity=" << segmentCapacity << ", segments=";
-        int segmentCount = 0;
-        Segment *current = head;
-        while (current)
+        if (limit < 0)
         {
-            segmentCount++;
-            current = current->next;
+            throw std::invalid_argument("Spare limit cannot be negative");
+        }
+
+        spareLimit = limit;
+        while (spareCount > spareLimit)
+        {
+            Segment *segment = spare;
+            spare = spare->next;
+            spareCount--;
+            Segment::Destroy(segment, resource);
+        }
+    }
+
+    int GetSpareLimit() const
+    {
+        return spareLimit;
+    }
+
+    int GetSpareCount() const
+    {
+        return spareCount;
+    }
+
+    // Освобождает все сегменты из кэша
+    void ReleaseSpares()
+    {
+        while (spare)
+        {
+            Segment *segment = spare;
+            spare = spare->next;
+            Segment::Destroy(segment, resource);
         }
-        std::cout << segmentCount << "):" << std::endl;
+        spareCount = 0;
+    }
+
+    void PrintDebugInfo() const
+    {
+        std::cout << "SegmentedDeque (size=" << totalSize << ", capacity=" << segmentSize() << ", segments=";
+        std::cout << segmentCount() << "):" << std::endl;
 
-        current = head;
+        Segment *current = head;
         int segNum = 0;
         while (current)
         {
-            std::cout << "  Segment " << segNum++ << " (size=" << current->data.GetSize()
-                      << ", capacity=" << current->data.GetCapacity() << "): ";
-            for (int i = 0; i < current->data.GetSize(); ++i)
+            std::cout << "  Segment " << segNum++ << " (size=" << current->GetSize()
+                      << ", capacity=" << current->GetCapacity() << "): ";
+            for (int i = 0; i < current->GetSize(); ++i)
             {
-                std::cout << current->data.Get(i) << " ";
+                std::cout << current->At(i) << " ";
             }
             std::cout << std::endl;
             current = current->next;
@@ -687,6 +1836,33 @@ public:
     }
 };
 
+// Дек с ёмкостью сегмента, подобранной по размеру элемента при компиляции
+template <typename T, int N = DefaultSegmentCapacity<T>()>
+using FixedSegmentedDeque = SegmentedDeque<T, N>;
+
+// Элемент, копирование которого бросает исключение, когда copiesLeft доходит до нуля
+struct FragileItem
+{
+    int value;
+    static int copiesLeft;
+
+    FragileItem(int value) : value(value)
+    {
+    }
+
+    FragileItem(const FragileItem &other) : value(other.value)
+    {
+        if (copiesLeft > 0 && --copiesLeft == 0)
+        {
+            throw std::runtime_error("copy failed");
+        }
+    }
+
+    FragileItem &operator=(const FragileItem &other) = default;
+};
+
+int FragileItem::copiesLeft = 0;
+
 int main()
 {
     try
@@ -733,6 +1909,7 @@ int main()
         std::cout << "\nТест Reserve(20):\n";
         dq.Reserve(20);
         dq.PrintDebugInfo();
+        std::cout << "Сегментов в кэше: " << dq.GetSpareCount() << std::endl;
         
         // Тест оператора присваивания
         std::cout << "\nТест оператора присваивания:\n";
@@ -764,6 +1941,35 @@ int main()
         std::cout << "Размер: " << dqDouble.GetLength() << ", Первый: " << dqDouble.GetFirst() 
                   << ", Последний: " << dqDouble.GetLast() << std::endl;
         
+        // Параллельная сортировка double с NaN и -0.0 даёт тот же порядок, что и обычная
+        std::cout << "\nТест SortInPlaceParallel с NaN и -0.0:\n";
+        SegmentedDeque<double> dqSpecial;
+        for (int i = 0; i < 100000; ++i)
+        {
+            double value = (i * 7919 % 1000) - 500.0;
+            if (i % 97 == 0)
+            {
+                value = std::numeric_limits<double>::quiet_NaN();
+            }
+            else if (i % 89 == 0)
+            {
+                value = -0.0;
+            }
+            dqSpecial.AppendInPlace(value);
+        }
+        SegmentedDeque<double> dqSpecialSerial(dqSpecial);
+        dqSpecial.SortInPlaceParallel(std::less<double>(), 4);
+        dqSpecialSerial.SortInPlace();
+        bool sameOrder = true;
+        for (int i = 0; i < dqSpecial.GetLength(); ++i)
+        {
+            double a = dqSpecial.Get(i);
+            double b = dqSpecialSerial.Get(i);
+            sameOrder = sameOrder && std::memcmp(&a, &b, sizeof(double)) == 0;
+        }
+        std::cout << "Порядок совпадает: " << (sameOrder ? "true" : "false")
+                  << ", последний - NaN: " << (std::isnan(dqSpecial.GetLast()) ? "true" : "false") << std::endl;
+
         // Тест с string
         std::cout << "\nТест с string:\n";
         SegmentedDeque<std::string> dqString(2);
@@ -789,6 +1995,229 @@ int main()
         }
         std::cout << std::endl;
 
+        // Тест с ёмкостью сегмента, заданной при компиляции
+        std::cout << "\nТест SegmentedDeque<int, 4>:\n";
+        SegmentedDeque<int, 4> dqFixed;
+        for (int i = 1; i <= 10; ++i)
+        {
+            dqFixed.AppendInPlace(i);
+        }
+        dqFixed.PrependInPlace(0);
+        dqFixed.InsertAtInPlace(42, 5);
+        dqFixed.PrintDebugInfo();
+        std::cout << "Ёмкость сегмента по умолчанию для int: " << FixedSegmentedDeque<int>().GetSegmentCapacity() << std::endl;
+
+        // Исключение при вставке в полный сегмент не меняет дек
+        std::cout << "\nТест исключения в InsertAtInPlace:\n";
+        SegmentedDeque<FragileItem> dqFragile(2);
+        for (int i = 1; i <= 4; ++i)
+        {
+            dqFragile.AppendInPlace(FragileItem(i));
+        }
+        FragileItem::copiesLeft = 3;
+        try
+        {
+            dqFragile.InsertAtInPlace(FragileItem(42), 1);
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cout << "Перехвачено: " << e.what() << std::endl;
+        }
+        FragileItem::copiesLeft = 0;
+        std::cout << "Размер: " << dqFragile.GetLength() << ", элементы: ";
+        dqFragile.ForEach([](const FragileItem &item) { std::cout << item.value << " "; });
+        std::cout << std::endl;
+
+        // Тест ленивого конвейера: фильтр, преобразование и свёртка за один проход
+        std::cout << "\nТест Lazy():\n";
+        int evenSquares = dqFixed.Lazy()
+                              .Where([](int x) { return x % 2 == 0; })
+                              .Map([](int x) { return x * x; })
+                              .Reduce([](int acc, int x) { return acc + x; }, 0);
+        std::cout << "Сумма квадратов чётных: " << evenSquares << std::endl;
+        SegmentedDeque<std::string, 4> *labels = dqFixed.Lazy()
+                                                     .Where([](int x) { return x > 7; })
+                                                     .Map([](int x) { return "#" + std::to_string(x); })
+                                                     .Materialize();
+        std::cout << "Метки: ";
+        labels->ForEach([](const std::string &label) { std::cout << label << " "; });
+        std::cout << std::endl;
+        delete labels;
+
+        // Тест изменения на месте: без второго дека
+        std::cout << "\nТест TransformInPlace и EraseIf:\n";
+        dqFixed.TransformInPlace([](int x) { return x * 10; });
+        int erased = dqFixed.EraseIf([](int x) { return x % 20 != 0; });
+        std::cout << "Удалено: " << erased << std::endl;
+        dqFixed.PrintDebugInfo();
+
+        // Тест RopeSequence: вставка в середину, разрезание и склейка
+        std::cout << "\nТест RopeSequence:\n";
+        RopeSequence<int> rope;
+        for (int i = 0; i < 1000; ++i)
+        {
+            rope.AppendInPlace(i);
+        }
+        rope.InsertAtInPlace(-1, 500);
+        RopeSequence<int> ropeTail = rope.Split(250);
+        rope.AppendMoved(std::move(ropeTail));
+        std::cout << "Размер: " << rope.GetLength() << ", элементы 499-501: " << rope.Get(499) << " "
+                  << rope.Get(500) << " " << rope.Get(501) << std::endl;
+
+        // Тест ArraySequence: добавление в начало заворачивает элементы через
+        // конец кольцевого буфера, Linearize() выкладывает их подряд
+        std::cout << "\nТест ArraySequence на кольцевом буфере:\n";
+        ArraySequence<int> ring;
+        for (int i = 0; i < 6; ++i)
+        {
+            ring.AppendInPlace(i);
+        }
+        ring.PrependInPlace(-1);
+        ring.PrependInPlace(-2);
+        ring.PopBack();
+        ring.AppendInPlace(6);
+        int *items = ring.Linearize();
+        bool contiguous = true;
+        std::cout << "Подряд: ";
+        for (int i = 0; i < ring.GetLength(); ++i)
+        {
+            contiguous = contiguous && items[i] == ring.Get(i);
+            std::cout << items[i] << " ";
+        }
+        std::cout << ", совпадает с Get: " << (contiguous ? "true" : "false") << std::endl;
+
+        // Тест SequenceView: срез читает элементы дека на месте, вложенный срез
+        // остаётся действительным и после уничтожения внешнего
+        std::cout << "\nТест SequenceView:\n";
+        SegmentedDeque<int> dqView(4);
+        for (int i = 0; i < 20; ++i)
+        {
+            dqView.AppendInPlace(i);
+        }
+        const SegmentedDeque<int> &dqViewRef = dqView;
+        bool viewShares = false;
+        SequenceView<int, SegmentedDeque<int>> inner = [&]()
+        {
+            SequenceView<int, SegmentedDeque<int>> outer = dqViewRef.GetSlice(5, 14);
+            viewShares = &*outer.begin() == &*(dqViewRef.begin() + 5);
+            return outer.GetSlice(2, 4);
+        }();
+        std::cout << "Без копирования: " << (viewShares ? "true" : "false") << ", вложенный срез: ";
+        for (int item : inner)
+        {
+            std::cout << item << " ";
+        }
+        Sequence<int> *materialized = inner.Materialize();
+        std::cout << ", копия: " << materialized->GetLength() << " элемента" << std::endl;
+        delete materialized;
+
+        // Тест UnrolledListSequence: узлы по 4 элемента, правки на их границах
+        std::cout << "\nТест UnrolledListSequence:\n";
+        UnrolledListSequence<int, 4> unrolled;
+        for (int i = 0; i < 12; ++i)
+        {
+            unrolled.AppendInPlace(i);
+        }
+        unrolled.InsertAtInPlace(100, 4);
+        unrolled.InsertAtInPlace(101, 9);
+        unrolled.PrependInPlace(-1);
+        unrolled.RemoveAt(5);
+        unrolled.RemoveAt(9);
+        unrolled.RemoveAt(unrolled.GetLength() - 1);
+        std::cout << "Элементы: ";
+        unrolled.ForEach([](const int &item) { std::cout << item << " "; });
+        std::cout << std::endl;
+
+        // Тест ImmutableSequence: новые версии не меняют старую, а копия
+        // и производные версии делят с ней узлы (считаем байты в арене)
+        std::cout << "\nТест ImmutableSequence:\n";
+        ArenaResource treeArena;
+        {
+            ArraySequence<int> *source = new ArraySequence<int>();
+            for (int i = 0; i < 1000; ++i)
+            {
+                source->AppendInPlace(i);
+            }
+            ImmutableSequence<int> base(source, &treeArena);
+            std::size_t builtBytes = treeArena.GetUsedBytes();
+
+            ImmutableSequence<int> copy(base);
+            bool copyIsFree = treeArena.GetUsedBytes() == builtBytes;
+
+            Sequence<int> *appended = base.Append(1000);
+            std::size_t appendBytes = treeArena.GetUsedBytes() - builtBytes;
+            Sequence<int> *inserted = base.InsertAt(-1, 500);
+            Sequence<int> *joined = base.Concat(&copy);
+            Sequence<int> *slice = base.GetSubsequence(100, 199);
+
+            bool unchanged = base.GetLength() == 1000;
+            for (int i = 0; i < base.GetLength(); ++i)
+            {
+                unchanged = unchanged && base.Get(i) == i;
+            }
+            std::cout << "Исходная версия не изменилась: " << (unchanged ? "true" : "false") << std::endl;
+            std::cout << "Копия без выделений: " << (copyIsFree ? "true" : "false")
+                      << ", Append выделил " << appendBytes << " из " << builtBytes << " байт дерева" << std::endl;
+            std::cout << "Производные: " << appended->GetLast() << " " << inserted->Get(500) << " "
+                      << joined->GetLength() << " " << slice->GetFirst() << std::endl;
+            delete appended;
+            delete inserted;
+            delete joined;
+            delete slice;
+        }
+
+        // Тест GapBufferSequence: правки рядом с курсором
+        std::cout << "\nТест GapBufferSequence:\n";
+        GapBufferSequence<char> text;
+        for (char c : std::string("hello world"))
+        {
+            text.AppendInPlace(c);
+        }
+        text.MoveCursor(5);
+        text.EmplaceAtCursor(',');
+        text.EraseAfterCursor();
+        text.EmplaceAtCursor(' ');
+        text.MoveCursor(text.GetLength());
+        text.EmplaceAtCursor('!');
+        std::cout << "Текст: " << std::string(text.begin(), text.end()) << ", курсор: " << text.GetCursor() << std::endl;
+
+        // Тест с ареной: память всех контейнеров освобождается одним Release()
+        std::cout << "\nТест с ArenaResource:\n";
+        ArenaResource arena;
+        {
+            SegmentedDeque<int> dqArena(4, &arena);
+            ArraySequence<int> arrArena(&arena);
+            ListSequence<int> listArena(&arena);
+            for (int i = 0; i < 10; ++i)
+            {
+                dqArena.AppendInPlace(i);
+                arrArena.AppendInPlace(i * i);
+                listArena.PrependInPlace(i);
+            }
+            std::cout << "Размеры: " << dqArena.GetLength() << " " << arrArena.GetLength() << " " << listArena.GetLength()
+                      << ", последние: " << dqArena.GetLast() << " " << arrArena.GetLast() << " " << listArena.GetLast() << std::endl;
+        }
+        std::cout << "Арена не пуста: " << (arena.GetUsedBytes() > 0 ? "true" : "false") << std::endl;
+        arena.Release();
+        std::cout << "После Release: " << arena.GetUsedBytes() << std::endl;
+
+        // Пул: сегменты, освобождённые при работе дека как очереди, выдаются повторно
+        std::cout << "\nТест с PoolResource:\n";
+        PoolResource pool;
+        {
+            SegmentedDeque<int> dqPool(4, &pool);
+            for (int i = 0; i < 1000; ++i)
+            {
+                dqPool.AppendInPlace(i);
+                if (i % 2 == 1)
+                {
+                    dqPool.PopFront();
+                }
+            }
+            std::cout << "Размер: " << dqPool.GetLength() << ", первый: " << dqPool.GetFirst() << std::endl;
+        }
+        pool.release();
+
         std::cout << "\n=== Все тесты завершены успешно ===\n";
     }
     catch (const std::exception &e)
@@ -1,7 +1,15 @@
+#pragma once
+
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <stdexcept>
+#include <utility>
 #include "linkedlist.cpp"
+#include "unrolledlist.cpp"
 #include "dynamicarray.cpp"
+#include "ringbuffer.cpp"
+#include "persistenttree.cpp"
 
 template <typename T>
 class Sequence {
@@ -18,23 +26,113 @@ public:
     virtual Sequence<T>    *Prepend(T item)                          const = 0;
     virtual Sequence<T>    *InsertAt(T item, int idx)                const = 0;
     virtual Sequence<T>    *Concat(Sequence<T> *other)               const = 0;
+
+    // Обход элементов по порядку; реализации заменяют Get(i) своими итераторами
+    virtual void ForEach(const std::function<void(const T &)> &action) const {
+        for (int i = 0; i < GetLength(); ++i) action(Get(i));
+    }
 };
 
 template <typename T>
 class MutableSequence : public Sequence<T> {
 public:
-    virtual void AppendInPlace(T item)               = 0;
-    virtual void PrependInPlace(T item)              = 0;
-    virtual void InsertAtInPlace(T item, int index)  = 0;
+    virtual void AppendInPlace(const T &item)               = 0;
+    virtual void AppendInPlace(T &&item)                    = 0;
+    virtual void PrependInPlace(const T &item)              = 0;
+    virtual void PrependInPlace(T &&item)                   = 0;
+    virtual void InsertAtInPlace(const T &item, int index)  = 0;
+    virtual void InsertAtInPlace(T &&item, int index)       = 0;
+};
+
+// Диапазон [l, r] последовательности Owner без копирования: элементы читаются
+// итераторами владельца, вложенные срезы сужают тот же диапазон.
+// Представление действительно, пока владелец жив и не изменяется;
+// Materialize() возвращает владеющую копию того же типа, что и Owner
+template <typename T, typename Owner>
+class SequenceView : public Sequence<T> {
+public:
+    using ConstIterator = typename Owner::ConstIterator;
+
+    SequenceView(const Owner &owner, int l, int r) : owner(&owner), start(l), length(r - l + 1) {
+        if (l < 0 || r >= owner.GetLength() || l > r) throw std::out_of_range("Invalid indices");
+        first = iteratorAt(owner.begin(), owner.end(), l, owner.GetLength());
+        last  = iteratorAt(first, owner.end(), length, owner.GetLength() - l);
+    }
+
+    T GetFirst() const override { return *first; }
+    T GetLast()  const override { return *std::prev(last); }
+    T Get(int i) const override {
+        if (i < 0 || i >= length) throw std::out_of_range("Index out of range");
+        return *iteratorAt(first, last, i, length);
+    }
+    int GetLength() const override { return length; }
+
+    SequenceView GetSlice(int l, int r) const {
+        if (l < 0 || r >= length || l > r) throw std::out_of_range("Invalid indices");
+        ConstIterator from = iteratorAt(first, last, l, length);
+        return SequenceView(owner, start + l, r - l + 1, from, iteratorAt(from, last, r - l + 1, length - l));
+    }
+    Sequence<T>* GetSubsequence(int l, int r) const override { return new SequenceView(GetSlice(l, r)); }
+
+    Sequence<T>* Materialize() const { return owner->GetSubsequence(start, start + length - 1); }
+
+    // Операции, создающие новую последовательность, работают с копией диапазона
+    Sequence<T>* Append(T item) const override { return withCopy([&](Sequence<T> *copy) { return copy->Append(std::move(item)); }); }
+    Sequence<T>* Prepend(T item) const override { return withCopy([&](Sequence<T> *copy) { return copy->Prepend(std::move(item)); }); }
+    Sequence<T>* InsertAt(T item, int idx) const override {
+        return withCopy([&](Sequence<T> *copy) { return copy->InsertAt(std::move(item), idx); });
+    }
+    Sequence<T>* Concat(Sequence<T>* other) const override { return withCopy([&](Sequence<T> *copy) { return copy->Concat(other); }); }
+
+    void ForEach(const std::function<void(const T &)> &action) const override {
+        for (const T &item : *this) action(item);
+    }
+
+    ConstIterator begin() const { return first; }
+    ConstIterator end()   const { return last; }
+
+private:
+    const Owner  *owner;
+    int           start;
+    int           length;
+    ConstIterator first;
+    ConstIterator last;
+
+    SequenceView(const Owner *owner, int start, int length, ConstIterator first, ConstIterator last)
+        : owner(owner), start(start), length(length), first(first), last(last) {}
+
+    // Итератор на i-й из count элементов [from, to); для списков идёт с ближнего конца
+    static ConstIterator iteratorAt(ConstIterator from, ConstIterator to, int i, int count) {
+        return i <= count / 2 ? std::next(from, i) : std::prev(to, count - i);
+    }
+
+    template <typename Operation>
+    Sequence<T>* withCopy(Operation operation) const {
+        Sequence<T> *copy = Materialize();
+        try {
+            Sequence<T> *result = operation(copy);
+            delete copy;
+            return result;
+        } catch (...) {
+            delete copy;
+            throw;
+        }
+    }
 };
 
+// Элементы лежат в кольцевом буфере: добавление и удаление на обоих концах -
+// амортизированно O(1), вставка в середину сдвигает меньшую часть.
+// Linearize() даёт непрерывный массив элементов
 template <typename T>
 class ArraySequence : public MutableSequence<T> {
 public:
     ArraySequence() = default;
-    ArraySequence(T *items, int n) : arr(items, n) {}
+    explicit ArraySequence(std::pmr::memory_resource *resource) : arr(resource) {}
+    ArraySequence(T *items, int n, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : arr(items, n, resource) {}
     
     ArraySequence(const ArraySequence &other) : arr(other.arr) {}
+    ArraySequence(ArraySequence &&other) noexcept : arr(std::move(other.arr)) {}
     
     ArraySequence& operator=(const ArraySequence &other) {
         if (this != &other) {
@@ -43,6 +141,11 @@ public:
         return *this;
     }
 
+    ArraySequence& operator=(ArraySequence &&other) noexcept {
+        arr = std::move(other.arr);
+        return *this;
+    }
+
     T GetFirst() const override {
         if (!arr.GetSize()) throw std::out_of_range("Sequence is empty");
         return arr.Get(0);
@@ -55,163 +158,242 @@ public:
 
     Sequence<T>* GetSubsequence(int l, int r) const override {
         if (l < 0 || r >= arr.GetSize() || l > r) throw std::out_of_range("Invalid indices");
-        auto *sub = new ArraySequence<T>();
-        for (int i = l; i <= r; ++i) sub->AppendInPlace(arr.Get(i));
+        auto *sub = new ArraySequence<T>(arr.GetResource());
+        sub->arr.Reserve(r - l + 1);
+        for (auto it = arr.begin() + l; it != arr.begin() + r + 1; ++it) sub->AppendInPlace(*it);
         return sub;
     }
+    SequenceView<T, ArraySequence> GetSlice(int l, int r) const { return SequenceView<T, ArraySequence>(*this, l, r); }
     int GetLength() const override { return arr.GetSize(); }
+    std::pmr::memory_resource *GetResource() const { return arr.GetResource(); }
 
     Sequence<T>* Append(T item) const override {
         auto *copy = new ArraySequence<T>(*this);
-        copy->AppendInPlace(item);
+        copy->AppendInPlace(std::move(item));
         return copy;
     }
     Sequence<T>* Prepend(T item) const override {
-        auto *res = new ArraySequence<T>();
-        res->AppendInPlace(item);
-        for (int i = 0; i < arr.GetSize(); ++i) res->AppendInPlace(arr.Get(i));
-        return res;
+        auto *copy = new ArraySequence<T>(*this);
+        copy->PrependInPlace(std::move(item));
+        return copy;
     }
     Sequence<T>* InsertAt(T item, int idx) const override {
         if (idx < 0 || idx > arr.GetSize()) throw std::out_of_range("Index out of range");
-        auto *res = new ArraySequence<T>();
-        for (int i = 0; i < idx; ++i) res->AppendInPlace(arr.Get(i));
-        res->AppendInPlace(item);
-        for (int i = idx; i < arr.GetSize(); ++i) res->AppendInPlace(arr.Get(i));
+        auto *res = new ArraySequence<T>(arr.GetResource());
+        res->arr.Reserve(arr.GetSize() + 1);
+        for (auto it = arr.begin(); it != arr.begin() + idx; ++it) res->AppendInPlace(*it);
+        res->AppendInPlace(std::move(item));
+        for (auto it = arr.begin() + idx; it != arr.end(); ++it) res->AppendInPlace(*it);
         return res;
     }
     Sequence<T>* Concat(Sequence<T>* other) const override {
         auto *res = new ArraySequence<T>(*this);
-        for (int i = 0; i < other->GetLength(); ++i) res->AppendInPlace(other->Get(i));
+        res->arr.Reserve(arr.GetSize() + other->GetLength());
+        other->ForEach([res](const T &item) { res->AppendInPlace(item); });
         return res;
     }
 
-    void AppendInPlace(T item) override { arr.Append(item); }
-
-    void PrependInPlace(T item) override {
-        arr.Resize(arr.GetSize() + 1);
-        for (int i = arr.GetSize() - 1; i > 0; --i) arr.Set(i, arr.Get(i - 1));
-        arr.Set(0, item);
+    void ForEach(const std::function<void(const T &)> &action) const override {
+        for (const T &item : arr) action(item);
     }
 
-    void InsertAtInPlace(T item, int idx) override {
-        if (idx < 0 || idx > arr.GetSize()) throw std::out_of_range("Index out of range");
-        
-        int oldSize = arr.GetSize();
-        arr.Resize(oldSize + 1);
-        
-        for (int i = oldSize; i > idx; --i) {
-            arr.Set(i, arr.Get(i - 1));
-        }
-        
-        arr.Set(idx, item);
-    }
+    using Iterator      = typename RingBuffer<T>::Iterator;
+    using ConstIterator = typename RingBuffer<T>::ConstIterator;
+
+    Iterator      begin()       { return arr.begin(); }
+    Iterator      end()         { return arr.end(); }
+    ConstIterator begin() const { return arr.begin(); }
+    ConstIterator end()   const { return arr.end(); }
+
+    void AppendInPlace(const T &item) override { arr.Append(item); }
+    void AppendInPlace(T &&item) override { arr.Append(std::move(item)); }
+
+    void PrependInPlace(const T &item) override { arr.Prepend(item); }
+    void PrependInPlace(T &&item) override { arr.Prepend(std::move(item)); }
+
+    void InsertAtInPlace(const T &item, int idx) override { EmplaceAt(idx, item); }
+    void InsertAtInPlace(T &&item, int idx) override { EmplaceAt(idx, std::move(item)); }
+
+    template <typename... Args>
+    void EmplaceBack(Args &&...args) { arr.EmplaceBack(std::forward<Args>(args)...); }
+    template <typename... Args>
+    void EmplaceFront(Args &&...args) { arr.EmplaceFront(std::forward<Args>(args)...); }
+    template <typename... Args>
+    void EmplaceAt(int idx, Args &&...args) { arr.EmplaceAt(idx, std::forward<Args>(args)...); }
+
+    T PopFront() { return arr.PopFront(); }
+    T PopBack()  { return arr.PopBack(); }
+    T RemoveAt(int idx) { return arr.RemoveAt(idx); }
+
+    // Указатель на элементы подряд; действителен до следующего изменения
+    T *Linearize() { return arr.Linearize(); }
 
 private:
-    DynamicArray<T> arr;
+    RingBuffer<T> arr;
 };
 
 
-template <typename T>
+// Storage - LinkedList<T> или UnrolledList<T>
+template <typename T, typename Storage = LinkedList<T>>
 class ListSequence : public MutableSequence<T> {
 public:
     ListSequence() = default;
-    ListSequence(T *items, int n) { for (int i = 0; i < n; ++i) list.Append(items[i]); }
-    ListSequence(const ListSequence &o) { for (int i = 0; i < o.GetLength(); ++i) list.Append(o.Get(i)); }
+    explicit ListSequence(std::pmr::memory_resource *resource) : list(resource) {}
+    explicit ListSequence(std::shared_ptr<typename Storage::Pool> pool) : list(pool) {}
+    ListSequence(T *items, int n, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : list(items, n, resource) {}
+    ListSequence(const ListSequence &o) : list(o.list) {}
+    ListSequence(ListSequence &&o) noexcept : list(std::move(o.list)) {}
+
+    ListSequence& operator=(const ListSequence &o) {
+        list = o.list;
+        return *this;
+    }
 
-    T GetFirst() const override { if (!list.GetLength()) throw std::out_of_range("Sequence is empty"); return list.Get(0); }
-    T GetLast()  const override { if (!list.GetLength()) throw std::out_of_range("Sequence is empty"); return list.Get(list.GetLength() - 1); }
+    ListSequence& operator=(ListSequence &&o) noexcept {
+        list = std::move(o.list);
+        return *this;
+    }
+
+    T GetFirst() const override { if (!list.GetLength()) throw std::out_of_range("Sequence is empty"); return list.GetFirst(); }
+    T GetLast()  const override { if (!list.GetLength()) throw std::out_of_range("Sequence is empty"); return list.GetLast(); }
     T Get(int i) const override { return list.Get(i); }
 
     Sequence<T>* GetSubsequence(int l, int r) const override {
         if (l < 0 || r >= list.GetLength() || l > r) throw std::out_of_range("Invalid indices");
-        auto *sub = new ListSequence<T>();
-        for (int i = l; i <= r; ++i) sub->AppendInPlace(list.Get(i));
+        auto *sub = new ListSequence(list.GetResource());
+        auto it = std::next(list.begin(), l);
+        for (int i = l; i <= r; ++i, ++it) sub->AppendInPlace(*it);
         return sub;
     }
+    SequenceView<T, ListSequence> GetSlice(int l, int r) const { return SequenceView<T, ListSequence>(*this, l, r); }
     int GetLength() const override { return list.GetLength(); }
+    std::pmr::memory_resource *GetResource() const { return list.GetResource(); }
+    std::shared_ptr<typename Storage::Pool> GetPool() { return list.GetPool(); }
 
     Sequence<T>* Append(T item) const override {
-        auto *copy = new ListSequence<T>(*this);
-        copy->AppendInPlace(item);
+        auto *copy = new ListSequence(*this);
+        copy->AppendInPlace(std::move(item));
         return copy;
     }
     Sequence<T>* Prepend(T item) const override {
-        auto *res = new ListSequence<T>();
-        res->AppendInPlace(item);
-        for (int i = 0; i < list.GetLength(); ++i) res->AppendInPlace(list.Get(i));
+        auto *res = new ListSequence(list.GetResource());
+        res->AppendInPlace(std::move(item));
+        for (const T &x : list) res->AppendInPlace(x);
         return res;
     }
     Sequence<T>* InsertAt(T item, int idx) const override {
         if (idx < 0 || idx > list.GetLength()) throw std::out_of_range("Index out of range");
-        auto *res = new ListSequence<T>();
-        for (int i = 0; i < idx; ++i) res->AppendInPlace(list.Get(i));
-        res->AppendInPlace(item);
-        for (int i = idx; i < list.GetLength(); ++i) res->AppendInPlace(list.Get(i));
+        auto *res = new ListSequence(list.GetResource());
+        auto it = list.begin();
+        for (int i = 0; i < idx; ++i, ++it) res->AppendInPlace(*it);
+        res->AppendInPlace(std::move(item));
+        for (; it != list.end(); ++it) res->AppendInPlace(*it);
         return res;
     }
     Sequence<T>* Concat(Sequence<T>* other) const override {
-        auto *res = new ListSequence<T>(*this);
-        for (int i = 0; i < other->GetLength(); ++i) res->AppendInPlace(other->Get(i));
+        auto *res = new ListSequence(*this);
+        other->ForEach([res](const T &item) { res->AppendInPlace(item); });
         return res;
     }
 
-    void AppendInPlace(T item) override { list.Append(item); }
-    void PrependInPlace(T item) override { list.Prepend(item); }
-    void InsertAtInPlace(T item, int idx) override { list.InsertAt(item, idx); }
+    void ForEach(const std::function<void(const T &)> &action) const override {
+        for (const T &item : list) action(item);
+    }
+
+    using Iterator      = typename Storage::Iterator;
+    using ConstIterator = typename Storage::ConstIterator;
+
+    Iterator      begin()       { return list.begin(); }
+    Iterator      end()         { return list.end(); }
+    ConstIterator begin() const { return list.begin(); }
+    ConstIterator end()   const { return list.end(); }
+
+    void AppendInPlace(const T &item) override { list.Append(item); }
+    void AppendInPlace(T &&item) override { list.Append(std::move(item)); }
+    void PrependInPlace(const T &item) override { list.Prepend(item); }
+    void PrependInPlace(T &&item) override { list.Prepend(std::move(item)); }
+    void InsertAtInPlace(const T &item, int idx) override { list.InsertAt(item, idx); }
+    void InsertAtInPlace(T &&item, int idx) override { list.InsertAt(std::move(item), idx); }
+
+    template <typename... Args>
+    void EmplaceBack(Args &&...args) { list.EmplaceBack(std::forward<Args>(args)...); }
+    template <typename... Args>
+    void EmplaceFront(Args &&...args) { list.EmplaceFront(std::forward<Args>(args)...); }
+
+    void RemoveAt(int idx) { list.RemoveAt(idx); }
+
+    // Узлы other переходят в конец этой последовательности, other опустошается
+    void SpliceBack(ListSequence &other) { list.SpliceBack(other.list); }
+    void AppendMoved(ListSequence &&other) { list.SpliceBack(other.list); }
 
 private:
-    LinkedList<T> list;
+    Storage list;
 };
 
+template <typename T, int K = UnrolledNodeCapacity<T>()>
+using UnrolledListSequence = ListSequence<T, UnrolledList<T, K>>;
+
+// Неизменяемая последовательность на PersistentTree: копия - O(1),
+// Append/Prepend/InsertAt/Concat/GetSubsequence - O(log n), причём
+// новые версии делят с исходной все неизменённые узлы
 template <typename T>
 class ImmutableSequence : public Sequence<T> {
 public:
-    explicit ImmutableSequence(Sequence<T>* src) : seq(src) {}
-    
-    ~ImmutableSequence() { delete seq; }
-    
-    ImmutableSequence(const ImmutableSequence &o) {
-        if (o.seq->GetLength() > 0) {
-            seq = o.seq->GetSubsequence(0, o.seq->GetLength() - 1);
-        } else {
-            seq = new ArraySequence<T>();
-        }
+    // Забирает src во владение: элементы переносятся в дерево, src удаляется
+    explicit ImmutableSequence(Sequence<T>* src, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : tree(resource)
+    {
+        tree = fromSequence(*src, resource);
+        delete src;
     }
-    
-    ImmutableSequence& operator=(const ImmutableSequence &o) {
-        if (this != &o) {
-            delete seq;
-            if (o.seq->GetLength() > 0) {
-                seq = o.seq->GetSubsequence(0, o.seq->GetLength() - 1);
-            } else {
-                seq = new ArraySequence<T>();
-            }
-        }
-        return *this;
+
+    ImmutableSequence(const ImmutableSequence &o) = default;
+    ImmutableSequence(ImmutableSequence &&o) noexcept = default;
+    ImmutableSequence& operator=(const ImmutableSequence &o) = default;
+    ImmutableSequence& operator=(ImmutableSequence &&o) noexcept = default;
+
+    T GetFirst() const override {
+        if (!tree.GetLength()) throw std::out_of_range("Sequence is empty");
+        return tree.Get(0);
+    }
+    T GetLast() const override {
+        if (!tree.GetLength()) throw std::out_of_range("Sequence is empty");
+        return tree.Get(tree.GetLength() - 1);
     }
+    T Get(int i) const override { return tree.Get(i); }
+    int GetLength() const override { return tree.GetLength(); }
 
-    T GetFirst() const override { return seq->GetFirst(); }
-    T GetLast()  const override { return seq->GetLast(); }
-    T Get(int i) const override { return seq->Get(i); }
-    int GetLength() const override { return seq->GetLength(); }
-    
     Sequence<T>* GetSubsequence(int l, int r) const override { 
-        return new ImmutableSequence<T>(seq->GetSubsequence(l, r)); 
+        return new ImmutableSequence<T>(tree.Slice(l, r)); 
     }
     Sequence<T>* Append(T item) const override { 
-        return new ImmutableSequence<T>(seq->Append(item)); 
+        return new ImmutableSequence<T>(tree.Insert(tree.GetLength(), std::move(item))); 
     }
     Sequence<T>* Prepend(T item) const override { 
-        return new ImmutableSequence<T>(seq->Prepend(item)); 
+        return new ImmutableSequence<T>(tree.Insert(0, std::move(item))); 
     }
     Sequence<T>* InsertAt(T item, int idx) const override { 
-        return new ImmutableSequence<T>(seq->InsertAt(item, idx)); 
+        return new ImmutableSequence<T>(tree.Insert(idx, std::move(item))); 
     }
+    // С другой ImmutableSequence деревья сливаются без копирования элементов
     Sequence<T>* Concat(Sequence<T>* other) const override { 
-        return new ImmutableSequence<T>(seq->Concat(other)); 
+        if (auto *immutable = dynamic_cast<const ImmutableSequence *>(other))
+            return new ImmutableSequence<T>(tree.Concat(immutable->tree));
+        return new ImmutableSequence<T>(tree.Concat(fromSequence(*other, tree.GetResource())));
     }
 
+    void ForEach(const std::function<void(const T &)> &action) const override { tree.ForEach(action); }
+
 private:
-    Sequence<T>* seq;
-};
\ No newline at end of file
+    PersistentTree<T> tree;
+
+    explicit ImmutableSequence(PersistentTree<T> tree) : tree(std::move(tree)) {}
+
+    static PersistentTree<T> fromSequence(const Sequence<T> &seq, std::pmr::memory_resource *resource) {
+        DynamicArray<T> items;
+        items.Reserve(seq.GetLength());
+        seq.ForEach([&items](const T &item) { items.Append(item); });
+        return PersistentTree<T>::Build(items.begin(), items.GetSize(), resource);
+    }
+};
@@ -0,0 +1,361 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Диапазоны короче порога досортировываются вставками
+const int InsertionSortThreshold = 16;
+
+template <typename Iterator, typename Compare>
+void InsertionSort(Iterator first, Iterator last, Compare &comp) {
+    if (first == last) return;
+    for (Iterator i = first + 1; i != last; ++i) {
+        auto value = std::move(*i);
+        Iterator j = i;
+        for (; j != first && comp(value, *(j - 1)); --j) *j = std::move(*(j - 1));
+        *j = std::move(value);
+    }
+}
+
+template <typename Iterator, typename Compare>
+void siftDown(Iterator first, long root, long count, Compare &comp) {
+    auto value = std::move(*(first + root));
+    for (long child = 2 * root + 1; child < count; child = 2 * root + 1) {
+        if (child + 1 < count && comp(*(first + child), *(first + child + 1))) ++child;
+        if (!comp(value, *(first + child))) break;
+        *(first + root) = std::move(*(first + child));
+        root = child;
+    }
+    *(first + root) = std::move(value);
+}
+
+template <typename Iterator, typename Compare>
+void HeapSort(Iterator first, Iterator last, Compare &comp) {
+    long count = last - first;
+    for (long root = count / 2 - 1; root >= 0; --root) siftDown(first, root, count, comp);
+    for (long end = count - 1; end > 0; --end) {
+        std::swap(*first, *(first + end));
+        siftDown(first, 0, end, comp);
+    }
+}
+
+template <typename Iterator, typename Compare>
+void sortThree(Iterator a, Iterator b, Iterator c, Compare &comp) {
+    if (comp(*b, *a)) std::swap(*a, *b);
+    if (comp(*c, *b)) {
+        std::swap(*b, *c);
+        if (comp(*b, *a)) std::swap(*a, *b);
+    }
+}
+
+// Ставит в first медиану трёх (для больших диапазонов - медиану девяти) элементов
+template <typename Iterator, typename Compare>
+void choosePivot(Iterator first, Iterator last, Compare &comp) {
+    long count = last - first;
+    Iterator mid = first + count / 2;
+    if (count > 128) {
+        long step = count / 8;
+        sortThree(first, first + step, first + 2 * step, comp);
+        sortThree(mid - step, mid, mid + step, comp);
+        sortThree(last - 1 - 2 * step, last - 1 - step, last - 1, comp);
+        sortThree(first + step, mid, last - 1 - step, comp);
+    } else {
+        sortThree(first, mid, last - 1, comp);
+    }
+    std::swap(*first, *mid);
+}
+
+// Разбиение Хоара вокруг *first; возвращает итоговую позицию опорного элемента
+template <typename Iterator, typename Compare>
+Iterator partitionAroundFirst(Iterator first, Iterator last, Compare &comp) {
+    Iterator i = first;
+    Iterator j = last;
+    for (;;) {
+        do ++i; while (i != last && comp(*i, *first));
+        do --j; while (comp(*first, *j));
+        if (i >= j) break;
+        std::swap(*i, *j);
+    }
+    std::swap(*first, *j);
+    return j;
+}
+
+template <typename Iterator, typename Compare>
+void introSortLoop(Iterator first, Iterator last, int depthLimit, Compare &comp) {
+    while (last - first > InsertionSortThreshold) {
+        if (depthLimit-- == 0) {
+            HeapSort(first, last, comp);
+            return;
+        }
+        choosePivot(first, last, comp);
+        Iterator pivot = partitionAroundFirst(first, last, comp);
+        // Рекурсия по меньшей части ограничивает глубину стека логарифмом
+        if (pivot - first < last - pivot) {
+            introSortLoop(first, pivot, depthLimit, comp);
+            first = pivot + 1;
+        } else {
+            introSortLoop(pivot + 1, last, depthLimit, comp);
+            last = pivot;
+        }
+    }
+    InsertionSort(first, last, comp);
+}
+
+// Интроспективная сортировка: быстрая сортировка с переходом на пирамидальную
+// при вырождении разбиений, O(n log n) в худшем случае. Не устойчива.
+template <typename Iterator, typename Compare>
+void IntroSort(Iterator first, Iterator last, Compare comp) {
+    int depthLimit = 0;
+    for (long n = last - first; n > 1; n >>= 1) depthLimit += 2;
+    introSortLoop(first, last, depthLimit, comp);
+}
+
+// Слияние двух отсортированных диапазонов; при равенстве первым идёт элемент левого
+template <typename Iterator, typename Output, typename Compare>
+void mergeRuns(Iterator left, Iterator leftEnd, Iterator right, Iterator rightEnd, Output out, Compare &comp) {
+    while (left != leftEnd && right != rightEnd) {
+        if (comp(*right, *left)) *out++ = std::move(*right++);
+        else *out++ = std::move(*left++);
+    }
+    while (left != leftEnd) *out++ = std::move(*left++);
+    while (right != rightEnd) *out++ = std::move(*right++);
+}
+
+template <typename Iterator, typename Output, typename Compare>
+void mergePass(Iterator first, Iterator last, Output out, long width, Compare &comp) {
+    long count = last - first;
+    for (long lo = 0; lo < count; lo += 2 * width) {
+        long mid = std::min(lo + width, count);
+        long hi = std::min(lo + 2 * width, count);
+        mergeRuns(first + lo, first + mid, first + mid, first + hi, out + lo, comp);
+    }
+}
+
+// Устойчивая сортировка слиянием снизу вверх; buffer должен вмещать last - first элементов
+template <typename Iterator, typename Buffer, typename Compare>
+void StableSort(Iterator first, Iterator last, Buffer buffer, Compare comp) {
+    long count = last - first;
+    long width = InsertionSortThreshold;
+    for (long lo = 0; lo < count; lo += width)
+        InsertionSort(first + lo, first + std::min(lo + width, count), comp);
+
+    // Проходы слияния чередуют направление: диапазон -> буфер -> диапазон
+    bool inBuffer = false;
+    for (; width < count; width *= 2) {
+        if (inBuffer) mergePass(buffer, buffer + count, first, width, comp);
+        else mergePass(first, last, buffer, width, comp);
+        inBuffer = !inBuffer;
+    }
+    if (inBuffer)
+        for (long i = 0; i < count; ++i) *(first + i) = std::move(*(buffer + i));
+}
+
+// Короче этого параллельная сортировка выполняется последовательно
+const long ParallelSortThreshold = 1 << 16;
+const long MinElementsPerThread = 1 << 14;
+
+// Выполняет body(0) ... body(workers - 1), каждый вызов в своём потоке
+template <typename Body>
+void RunInParallel(int workers, Body body) {
+    std::vector<std::thread> threads;
+    for (int w = 1; w < workers; ++w) threads.emplace_back([&body, w]() { body(w); });
+    body(0);
+    for (std::thread &thread : threads) thread.join();
+}
+
+inline int ResolveThreadCount(int threads) {
+    if (threads > 0) return threads;
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    return hardware > 0 ? hardware : 1;
+}
+
+// Сколько элементов из left войдёт в первые k элементов слияния left и right
+template <typename Iterator, typename Compare>
+long coRank(long k, Iterator left, long leftCount, Iterator right, long rightCount, Compare &comp) {
+    long lo = std::max(0L, k - rightCount);
+    long hi = std::min(k, leftCount);
+    while (lo < hi) {
+        long i = (lo + hi) / 2;
+        long j = k - i;
+        if (j > 0 && i < leftCount && !comp(*(right + j - 1), *(left + i))) lo = i + 1;
+        else hi = i;
+    }
+    return lo;
+}
+
+// Один раунд слияния соседних пар серий из source в target. Выход делится между
+// потоками поровну; границы частей внутри пар находятся бинарным поиском заранее,
+// до того как потоки начнут перемещать элементы.
+template <typename Source, typename Target, typename Compare>
+void parallelMergeRound(Source source, Target target, const std::vector<long> &bounds, int workers, Compare &comp) {
+    long count = bounds.back();
+    int runs = static_cast<int>(bounds.size()) - 1;
+
+    // splits[w] - сколько элементов левой серии своей пары попадает до границы w-го потока
+    std::vector<long> splits(workers + 1);
+    for (int w = 0, r = 0; w <= workers; ++w) {
+        long boundary = count * w / workers;
+        while (r + 2 < runs && bounds[r + 2] <= boundary) r += 2;
+        long pairBegin = bounds[r];
+        long pairMid = bounds[std::min(r + 1, runs)];
+        long pairEnd = bounds[std::min(r + 2, runs)];
+        splits[w] = coRank(boundary - pairBegin, source + pairBegin, pairMid - pairBegin,
+                           source + pairMid, pairEnd - pairMid, comp);
+    }
+
+    RunInParallel(workers, [&](int w) {
+        long lo = count * w / workers;
+        long hi = count * (w + 1) / workers;
+        for (int r = 0; r < runs; r += 2) {
+            long pairBegin = bounds[r];
+            long pairMid = bounds[std::min(r + 1, runs)];
+            long pairEnd = bounds[std::min(r + 2, runs)];
+            if (pairEnd <= lo || pairBegin >= hi) continue;
+
+            long k0 = std::max(lo, pairBegin) - pairBegin;
+            long k1 = std::min(hi, pairEnd) - pairBegin;
+            long i0 = lo > pairBegin ? splits[w] : 0;
+            long i1 = hi < pairEnd ? splits[w + 1] : pairMid - pairBegin;
+            mergeRuns(source + pairBegin + i0, source + pairBegin + i1,
+                      source + pairMid + (k0 - i0), source + pairMid + (k1 - i1),
+                      target + pairBegin + k0, comp);
+        }
+    });
+}
+
+// Параллельная сортировка: диапазон делится между потоками, части сортируются
+// IntroSort, затем попарно сливаются через buffer (не меньше last - first элементов).
+// Сравнение не должно бросать исключений.
+template <typename Iterator, typename Buffer, typename Compare>
+void ParallelSort(Iterator first, Iterator last, Buffer buffer, Compare comp, int threads = 0) {
+    long count = last - first;
+    int workers = static_cast<int>(std::min<long>(ResolveThreadCount(threads), count / MinElementsPerThread));
+    if (count < ParallelSortThreshold || workers < 2) {
+        IntroSort(first, last, comp);
+        return;
+    }
+
+    std::vector<long> bounds;
+    for (int w = 0; w <= workers; ++w) bounds.push_back(count * w / workers);
+    RunInParallel(workers, [&](int w) { IntroSort(first + bounds[w], first + bounds[w + 1], comp); });
+
+    bool inBuffer = false;
+    while (bounds.size() > 2) {
+        if (inBuffer) parallelMergeRound(buffer, first, bounds, workers, comp);
+        else parallelMergeRound(first, buffer, bounds, workers, comp);
+        inBuffer = !inBuffer;
+
+        std::vector<long> merged;
+        for (std::size_t r = 0; r < bounds.size(); r += 2) merged.push_back(bounds[r]);
+        if (merged.back() != count) merged.push_back(count);
+        bounds.swap(merged);
+    }
+
+    if (inBuffer) {
+        RunInParallel(workers, [&](int w) {
+            for (long i = count * w / workers; i < count * (w + 1) / workers; ++i)
+                *(first + i) = std::move(*(buffer + i));
+        });
+    }
+}
+
+// Беззнаковый ключ, порядок которого совпадает с порядком значений T.
+// Для чисел с плавающей точкой -0.0 идёт перед +0.0, а NaN - в самом конце.
+template <typename T, typename Enable = void>
+struct RadixKey {
+    static const bool Supported = false;
+};
+
+template <typename T>
+struct RadixKey<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>> {
+    static const bool Supported = true;
+    using Type = std::make_unsigned_t<T>;
+
+    static Type Of(T value) {
+        Type key = static_cast<Type>(value);
+        if (std::is_signed<T>::value) key ^= static_cast<Type>(Type(1) << (sizeof(Type) * 8 - 1));
+        return key;
+    }
+};
+
+template <typename T>
+struct RadixKey<T, std::enable_if_t<std::is_floating_point<T>::value && (sizeof(T) == 4 || sizeof(T) == 8)>> {
+    static const bool Supported = true;
+    using Type = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+    static Type Of(T value) {
+        const Type signBit = Type(1) << (sizeof(Type) * 8 - 1);
+        if (value != value) return ~Type(0);
+        Type bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits & signBit ? ~bits : bits | signBit;
+    }
+};
+
+// Сравнение по ключу RadixKey: тот же порядок, что и у поразрядной сортировки
+template <typename T>
+struct RadixKeyLess {
+    bool operator()(const T &a, const T &b) const { return RadixKey<T>::Of(a) < RadixKey<T>::Of(b); }
+};
+
+// Поразрядная сортировка выгоднее сравнений начиная примерно с такого размера
+const long RadixSortThreshold = 256;
+
+// Сортировка по умолчанию (std::less) для арифметических типов может быть поразрядной
+template <typename T, typename Compare>
+constexpr bool UsesRadixSort() {
+    return RadixKey<T>::Supported && (std::is_same<Compare, std::less<T>>::value ||
+                                      std::is_same<Compare, std::less<>>::value);
+}
+
+template <typename Source, typename Target, typename Key>
+void radixPass(Source source, Target target, long count, int shift, long *offsets) {
+    using T = std::remove_reference_t<decltype(*source)>;
+    for (long i = 0; i < count; ++i) {
+        Key digit = (RadixKey<T>::Of(*(source + i)) >> shift) & 0xFF;
+        *(target + offsets[digit]++) = std::move(*(source + i));
+    }
+}
+
+// LSD поразрядная сортировка по байтам ключа, устойчивая. Гистограммы всех байтов
+// строятся за один проход, байты с одинаковым значением у всех элементов пропускаются.
+// buffer должен вмещать last - first элементов и используется во всех проходах.
+template <typename Iterator, typename Buffer>
+void RadixSort(Iterator first, Iterator last, Buffer buffer) {
+    using T = std::remove_reference_t<decltype(*first)>;
+    using Key = typename RadixKey<T>::Type;
+    const int passes = sizeof(Key);
+    long count = last - first;
+    if (count < 2) return;
+
+    std::vector<long> histogram(passes * 256, 0);
+    for (Iterator it = first; it != last; ++it) {
+        Key key = RadixKey<T>::Of(*it);
+        for (int d = 0; d < passes; ++d) ++histogram[d * 256 + ((key >> (8 * d)) & 0xFF)];
+    }
+
+    bool inBuffer = false;
+    for (int d = 0; d < passes; ++d) {
+        long *counts = &histogram[d * 256];
+        Key firstDigit = (RadixKey<T>::Of(*first) >> (8 * d)) & 0xFF;
+        if (counts[firstDigit] == count) continue;
+
+        long offset = 0;
+        for (int digit = 0; digit < 256; ++digit) {
+            long bucket = counts[digit];
+            counts[digit] = offset;
+            offset += bucket;
+        }
+        if (inBuffer) radixPass<Buffer, Iterator, Key>(buffer, first, count, 8 * d, counts);
+        else radixPass<Iterator, Buffer, Key>(first, buffer, count, 8 * d, counts);
+        inBuffer = !inBuffer;
+    }
+
+    if (inBuffer)
+        for (long i = 0; i < count; ++i) *(first + i) = std::move(*(buffer + i));
+}
@@ -0,0 +1,406 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "memoryresource.cpp"
+#include "nodepool.cpp"
+
+// Число элементов в узле по умолчанию: около 256 байт данных, но не меньше 8
+template <typename T>
+constexpr int UnrolledNodeCapacity() {
+    return sizeof(T) >= 32 ? 8 : static_cast<int>(256 / sizeof(T));
+}
+
+// Развёрнутый список: каждый узел хранит до K элементов подряд, поэтому обход
+// и поиск по индексу проходят в K раз меньше узлов. Полный узел при вставке
+// делится пополам, узел, заполненный меньше чем наполовину, после удаления
+// сливается с соседом, если их элементы помещаются в один узел.
+template <typename T, int K = UnrolledNodeCapacity<T>()>
+class UnrolledList {
+    static_assert(K >= 2, "Node capacity must be at least 2");
+
+public:
+    struct Node {
+        Node *next  = nullptr;
+        Node *prev  = nullptr;
+        int   count = 0;
+        alignas(T) unsigned char storage[K * sizeof(T)];
+
+        T *Items() { return std::launder(reinterpret_cast<T *>(storage)); }
+        const T *Items() const { return std::launder(reinterpret_cast<const T *>(storage)); }
+    };
+
+    using Pool = NodePool<Node>;
+
+    // Двунаправленный итератор: узел и позиция в нём; end() - пустой узел
+    template <bool IsConst>
+    class BasicIterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = std::conditional_t<IsConst, const T *, T *>;
+        using reference         = std::conditional_t<IsConst, const T &, T &>;
+
+        BasicIterator() = default;
+        BasicIterator(Node *node, int offset, const UnrolledList *list) : node(node), offset(offset), list(list) {}
+
+        template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+        BasicIterator(const BasicIterator<OtherConst> &other) : node(other.node), offset(other.offset), list(other.list) {}
+
+        reference operator*() const  { return node->Items()[offset]; }
+        pointer   operator->() const { return node->Items() + offset; }
+
+        BasicIterator &operator++() {
+            if (++offset == node->count) {
+                node = node->next;
+                offset = 0;
+            }
+            return *this;
+        }
+
+        BasicIterator &operator--() {
+            if (offset == 0) {
+                node = node ? node->prev : list->tail;
+                offset = node->count;
+            }
+            --offset;
+            return *this;
+        }
+
+        BasicIterator operator++(int) { BasicIterator old = *this; ++*this; return old; }
+        BasicIterator operator--(int) { BasicIterator old = *this; --*this; return old; }
+
+        bool operator==(const BasicIterator &other) const { return node == other.node && offset == other.offset; }
+        bool operator!=(const BasicIterator &other) const { return !(*this == other); }
+
+    private:
+        template <bool> friend class BasicIterator;
+
+        Node               *node   = nullptr;
+        int                 offset = 0;
+        const UnrolledList *list   = nullptr;
+    };
+
+    using Iterator      = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    UnrolledList() : UnrolledList(std::pmr::get_default_resource()) {}
+
+    explicit UnrolledList(std::pmr::memory_resource *resource) : resource(resource) {}
+
+    explicit UnrolledList(std::shared_ptr<Pool> pool) : pool(pool), resource(pool->GetResource()) {}
+
+    UnrolledList(T *items, int count, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : UnrolledList(resource)
+    {
+        if (count < 0) throw std::invalid_argument("Count cannot be negative");
+        for (int i = 0; i < count; ++i) Append(items[i]);
+    }
+
+    // Копия повторяет разбиение оригинала на узлы
+    UnrolledList(const UnrolledList &other) : UnrolledList(other.resource) { copyFrom(other); }
+
+    UnrolledList(UnrolledList &&other) noexcept
+        : head(other.head), tail(other.tail), length(other.length), pool(std::move(other.pool)), resource(other.resource)
+    {
+        other.head = other.tail = nullptr;
+        other.length = 0;
+    }
+
+    UnrolledList &operator=(const UnrolledList &other) {
+        if (this == &other) return *this;
+        UnrolledList copy = pool ? UnrolledList(pool) : UnrolledList(resource);
+        copy.copyFrom(other);
+        *this = std::move(copy);
+        return *this;
+    }
+
+    UnrolledList &operator=(UnrolledList &&other) noexcept {
+        if (this == &other) return *this;
+        clear();
+        head = other.head;
+        tail = other.tail;
+        length = other.length;
+        pool = std::move(other.pool);
+        resource = other.resource;
+        other.head = other.tail = nullptr;
+        other.length = 0;
+        return *this;
+    }
+
+    ~UnrolledList() { clear(); }
+
+    T GetFirst() const {
+        if (!head) throw std::runtime_error("List is empty");
+        return head->Items()[0];
+    }
+
+    T GetLast() const {
+        if (!tail) throw std::runtime_error("List is empty");
+        return tail->Items()[tail->count - 1];
+    }
+
+    T Get(int index) const {
+        if (index < 0 || index >= length) throw std::out_of_range("Index out of range");
+        auto [node, offset] = locate(index);
+        return node->Items()[offset];
+    }
+
+    int GetLength() const { return length; }
+
+    void Prepend(const T &item) { EmplaceFront(item); }
+    void Prepend(T &&item)      { EmplaceFront(std::move(item)); }
+    void Append(const T &item)  { EmplaceBack(item); }
+    void Append(T &&item)       { EmplaceBack(std::move(item)); }
+    void InsertAt(const T &item, int index) { EmplaceAt(index, item); }
+    void InsertAt(T &&item, int index)      { EmplaceAt(index, std::move(item)); }
+
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args) {
+        if (tail && tail->count < K) {
+            T *slot = new (tail->Items() + tail->count) T(std::forward<Args>(args)...);
+            ++tail->count;
+            ++length;
+            return *slot;
+        }
+        Node *node = createNodeWith(std::forward<Args>(args)...);
+        linkAfter(node, tail);
+        ++length;
+        return node->Items()[0];
+    }
+
+    template <typename... Args>
+    T &EmplaceFront(Args &&...args) {
+        if (head && head->count < K) {
+            // Аргументы могут ссылаться на элементы узла, которые будут сдвинуты
+            T item(std::forward<Args>(args)...);
+            ++length;
+            return insertInNode(head, 0, std::move(item));
+        }
+        Node *node = createNodeWith(std::forward<Args>(args)...);
+        linkAfter(node, nullptr);
+        ++length;
+        return node->Items()[0];
+    }
+
+    template <typename... Args>
+    T &EmplaceAt(int index, Args &&...args) {
+        if (index < 0 || index > length) throw std::out_of_range("Index out of range");
+        if (index == 0)      return EmplaceFront(std::forward<Args>(args)...);
+        if (index == length) return EmplaceBack(std::forward<Args>(args)...);
+
+        T item(std::forward<Args>(args)...);
+        auto [node, offset] = locate(index);
+        if (node->count == K) {
+            Node *right = split(node);
+            if (offset > node->count) {
+                offset -= node->count;
+                node = right;
+            }
+        }
+        ++length;
+        return insertInNode(node, offset, std::move(item));
+    }
+
+    void RemoveAt(int index) {
+        if (index < 0 || index >= length) throw std::out_of_range("Index out of range");
+        auto [node, offset] = locate(index);
+        T *items = node->Items();
+        std::move(items + offset + 1, items + node->count, items + offset);
+        std::destroy_at(items + node->count - 1);
+        --node->count;
+        --length;
+        rebalance(node);
+    }
+
+    void RemoveFirst() {
+        if (!head) throw std::runtime_error("List is empty");
+        RemoveAt(0);
+    }
+
+    void RemoveLast() {
+        if (!tail) throw std::runtime_error("List is empty");
+        RemoveAt(length - 1);
+    }
+
+    // Переносит узлы other в конец списка за O(1), other становится пустым.
+    // Пул этого списка принимает блоки пула other, так что узлы не копируются;
+    // новые узлы берутся из ресурса этого списка
+    void SpliceBack(UnrolledList &other) {
+        if (this == &other) throw std::invalid_argument("Cannot splice a list into itself");
+        if (!other.head) return;
+
+        GetPool()->Adopt(*other.pool);
+        if (head) {
+            tail->next = other.head;
+            other.head->prev = tail;
+        } else {
+            head = other.head;
+        }
+        tail = other.tail;
+        length += other.length;
+        other.head = other.tail = nullptr;
+        other.length = 0;
+    }
+
+    void AppendMoved(UnrolledList &&other) { SpliceBack(other); }
+
+    Node *GetHeadNode() const { return head; }
+    Node *GetTailNode() const { return tail; }
+    std::pmr::memory_resource *GetResource() const { return resource; }
+
+    Iterator      begin()       { return Iterator(head, 0, this); }
+    Iterator      end()         { return Iterator(nullptr, 0, this); }
+    ConstIterator begin() const { return ConstIterator(head, 0, this); }
+    ConstIterator end()   const { return ConstIterator(nullptr, 0, this); }
+
+    std::shared_ptr<Pool> GetPool() {
+        if (!pool) pool = std::make_shared<Pool>(resource);
+        return pool;
+    }
+
+private:
+    Node *head   = nullptr;
+    Node *tail   = nullptr;
+    int   length = 0;
+    std::shared_ptr<Pool>      pool;
+    std::pmr::memory_resource *resource;
+
+    Node *createNode() {
+        if (!pool) pool = std::make_shared<Pool>(resource);
+        return new (pool->Allocate()) Node();
+    }
+
+    // Новый узел с одним элементом; при исключении узел освобождается
+    template <typename... Args>
+    Node *createNodeWith(Args &&...args) {
+        Node *node = createNode();
+        try {
+            new (node->Items()) T(std::forward<Args>(args)...);
+        } catch (...) {
+            destroyNode(node);
+            throw;
+        }
+        node->count = 1;
+        return node;
+    }
+
+    void destroyNode(Node *node) {
+        std::destroy(node->Items(), node->Items() + node->count);
+        node->~Node();
+        pool->Deallocate(node);
+    }
+
+    // after == nullptr - вставка в начало
+    void linkAfter(Node *node, Node *after) {
+        node->prev = after;
+        node->next = after ? after->next : head;
+        if (node->next) node->next->prev = node;
+        else tail = node;
+        if (after) after->next = node;
+        else head = node;
+    }
+
+    void unlink(Node *node) {
+        if (node->prev) node->prev->next = node->next;
+        else head = node->next;
+        if (node->next) node->next->prev = node->prev;
+        else tail = node->prev;
+    }
+
+    // Узел и позиция в нём; обход идёт с ближнего к индексу конца
+    std::pair<Node *, int> locate(int index) const {
+        if (index < length / 2) {
+            Node *node = head;
+            while (index >= node->count) {
+                index -= node->count;
+                node = node->next;
+            }
+            return {node, index};
+        }
+        int rest = length - index;
+        Node *node = tail;
+        while (rest > node->count) {
+            rest -= node->count;
+            node = node->prev;
+        }
+        return {node, node->count - rest};
+    }
+
+    // Узел не полон: сдвигает хвост узла на одну позицию вправо
+    T &insertInNode(Node *node, int offset, T &&item) {
+        T *items = node->Items();
+        if (offset == node->count) {
+            new (items + offset) T(std::move(item));
+        } else {
+            new (items + node->count) T(std::move(items[node->count - 1]));
+            std::move_backward(items + offset, items + node->count - 1, items + node->count);
+            items[offset] = std::move(item);
+        }
+        ++node->count;
+        return items[offset];
+    }
+
+    // Переносит верхнюю половину узла в новый узел сразу после него
+    Node *split(Node *node) {
+        Node *right = createNode();
+        int half = node->count / 2;
+        T *items = node->Items();
+        std::uninitialized_move(items + half, items + node->count, right->Items());
+        std::destroy(items + half, items + node->count);
+        right->count = node->count - half;
+        node->count  = half;
+        linkAfter(right, node);
+        return right;
+    }
+
+    // Элементы right переносятся в конец left, right освобождается
+    void merge(Node *left, Node *right) {
+        std::uninitialized_move(right->Items(), right->Items() + right->count, left->Items() + left->count);
+        left->count += right->count;
+        unlink(right);
+        destroyNode(right);
+    }
+
+    void rebalance(Node *node) {
+        if (node->count == 0) {
+            unlink(node);
+            destroyNode(node);
+            return;
+        }
+        if (node->count >= K / 2) return;
+        if (node->next && node->count + node->next->count <= K) merge(node, node->next);
+        else if (node->prev && node->prev->count + node->count <= K) merge(node->prev, node);
+    }
+
+    void copyFrom(const UnrolledList &other) {
+        for (const Node *p = other.head; p; p = p->next) {
+            Node *node = createNode();
+            try {
+                std::uninitialized_copy(p->Items(), p->Items() + p->count, node->Items());
+            } catch (...) {
+                destroyNode(node);
+                throw;
+            }
+            node->count = p->count;
+            linkAfter(node, tail);
+            length += p->count;
+        }
+    }
+
+    void clear() {
+        while (head) {
+            Node *next = head->next;
+            destroyNode(head);
+            head = next;
+        }
+        tail = nullptr;
+        length = 0;
+    }
+};